@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Runs every query of every model in a directory of models laid out as
+# test_models (<model>/model.pnml and <model>/query.xml) with the CTL engine,
+# and records the explored configurations per second reported in the
+# statistics of each query. Reachability queries are forced through the CTL
+# engine with -noreach, and the query reduction is disabled so the engine is
+# not skipped. For every model a row with query "all" holds the configurations
+# per second over all of its queries.
+
+B=$1
+D=$2
+F=$3
+O="$4"
+
+if [ -z "$B" ] ; then
+	echo "Missing binary"
+	exit 2
+fi
+if [ -z "$D" ] ; then
+	echo "No model directory given, using test_models"
+	D=test_models
+fi
+if [ -z "$F" ] ; then
+	echo "Missing output"
+	exit 2
+fi
+
+echo "model,query,answer,explored configs,seconds,configs per second" > $F
+for f in $(ls $D) ; do
+	M="$D/$f/model.pnml"
+	Q="$D/$f/query.xml"
+	if [ ! -f "$M" ] || [ ! -f "$Q" ] ; then
+		continue
+	fi
+	NP=$(grep "<property>" $Q | wc -l)
+	total=0
+	seconds=0
+	for q in $(seq 1 $NP) ; do
+		res=$(eval "$B $O -noreach -q 0 -x $q $M $Q")
+		rate=$(echo "$res" | grep "Explored Configs/s:" | awk '{ print $3 }')
+		if [ -z "$rate" ] ; then
+			continue
+		fi
+		answer=$(echo "$res" | grep "Query is" | sed -e 's/.*Query is //' -e 's/ /_/g')
+		explored=$(echo "$res" | grep "Explored Configs  :" | awk '{ print $4 }')
+		time=$(echo "$res" | grep "Time (seconds)" | awk '{ print $4 }')
+		echo "$f:$q: $answer, $explored configurations in $time seconds, $rate configs/s"
+		echo "$f,$q,$answer,$explored,$time,$rate" >> $F
+		total=$(awk "BEGIN { print $total + $explored }")
+		seconds=$(awk "BEGIN { print $seconds + $time }")
+	done
+	if [ "$total" != "0" ] ; then
+		rate=$(awk "BEGIN { printf \"%.0f\", ($seconds > 0 ? $total / $seconds : 0) }")
+		echo "$f: $total configurations in $seconds seconds, $rate configs/s"
+		echo "$f,all,,$total,$seconds,$rate" >> $F
+	fi
+done
@@ -0,0 +1,62 @@
+#!/bin/bash
+
+# Explores the state space of every model in a directory of models laid out as
+# test_models (<model>/model.pnml and <model>/query.xml) with the parallel
+# reachability search, and reports the states per second of the whole run
+# (parsing and successor generation included) for each number of threads.
+# The number of states must not depend on the number of threads, a model where
+# it does is reported and the script exits with 1.
+# The shared state set alone is measured by the benchmark-stateset binary, built
+# next to verifypn when multi-core support is enabled.
+
+B=$1
+D=$2
+F=$3
+J=$4
+O="$5"
+
+if [ -z "$B" ] ; then
+	echo "Missing binary"
+	exit 2
+fi
+if [ -z "$D" ] ; then
+	echo "No model directory given, using test_models"
+	D=test_models
+fi
+if [ -z "$F" ] ; then
+	echo "Missing output"
+	exit 2
+fi
+if [ -z "$J" ] ; then
+	echo "No thread counts given, using 1 2 4 8"
+	J="1 2 4 8"
+fi
+
+echo "model,threads,states,seconds,states per second" > $F
+FAILED=0
+for f in $(ls $D) ; do
+	if [ ! -f "$D/$f/model.pnml" ] || [ ! -f "$D/$f/query.xml" ] ; then
+		continue
+	fi
+	expected=""
+	for j in $J ; do
+		start=$(date +%s.%N)
+		res=$(eval "$B $O -e -r 0 -q 0 -z $j $D/$f/model.pnml $D/$f/query.xml")
+		end=$(date +%s.%N)
+		states=$(echo "$res" | grep "STATE_SPACE STATES" | awk '{ print $3 }')
+		if [ -z "$states" ] ; then
+			continue
+		fi
+		time=$(echo "$end - $start" | bc -l)
+		rate=$(echo "$states / $time" | bc -l | xargs printf "%.0f")
+		echo "$f: $states states with $j threads in $time seconds, $rate states/s"
+		echo "$f,$j,$states,$time,$rate" >> $F
+		if [ -z "$expected" ] ; then
+			expected=$states
+		elif [ "$states" != "$expected" ] ; then
+			echo "$f: $states states with $j threads, $expected with the first thread count"
+			FAILED=1
+		fi
+	done
+done
+exit $FAILED
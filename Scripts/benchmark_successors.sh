@@ -0,0 +1,71 @@
+#!/bin/bash
+
+# Explores the state space of every model in a directory of models laid out as
+# test_models (<model>/model.pnml and <model>/query.xml) and reports the states
+# per second, and whether the net has inhibitor arcs.
+# If a reference binary is given, e.g. one built from a revision before the
+# successor generator was specialised for nets without inhibitor arcs, it is run
+# as well. Both must find the same number of states, a model where they do not
+# is reported and the script exits with 1.
+
+B=$1
+R=$2
+D=$3
+F=$4
+O="$5"
+
+if [ -z "$B" ] ; then
+	echo "Missing binary"
+	exit 2
+fi
+if [ -z "$D" ] ; then
+	echo "No model directory given, using test_models"
+	D=test_models
+fi
+if [ -z "$F" ] ; then
+	echo "Missing output"
+	exit 2
+fi
+
+# prints the number of states and the seconds it took
+explore() {
+	start=$(date +%s.%N)
+	res=$(eval "$1 $O -e -r 0 -q 0 -s DFS $2 $3")
+	end=$(date +%s.%N)
+	states=$(echo "$res" | grep "STATE_SPACE STATES" | awk '{ print $3 }')
+	echo "$states $(echo "$end - $start" | bc -l)"
+}
+
+echo "model,inhibitors,states,seconds,states per second,reference seconds,reference states per second" > $F
+FAILED=0
+for f in $(ls $D) ; do
+	M="$D/$f/model.pnml"
+	Q="$D/$f/query.xml"
+	if [ ! -f "$M" ] || [ ! -f "$Q" ] ; then
+		continue
+	fi
+	inhib="no"
+	if grep -q "inhibitor" $M ; then
+		inhib="yes"
+	fi
+	read states time <<< $(explore "$B" $M $Q)
+	if [ -z "$states" ] ; then
+		continue
+	fi
+	rate=$(echo "$states / $time" | bc -l | xargs printf "%.0f")
+	line="$f,$inhib,$states,$time,$rate"
+	echo "$f: $states states in $time seconds, $rate states/s"
+	if [ ! -z "$R" ] ; then
+		read rstates rtime <<< $(explore "$R" $M $Q)
+		if [ "$states" != "$rstates" ] ; then
+			echo "$f: $states states, reference: $rstates"
+			FAILED=1
+		elif [ ! -z "$rstates" ] ; then
+			rrate=$(echo "$rstates / $rtime" | bc -l | xargs printf "%.0f")
+			line="$line,$rtime,$rrate"
+			echo "$f: reference $rtime seconds, $rrate states/s"
+		fi
+	fi
+	echo "$line" >> $F
+done
+exit $FAILED
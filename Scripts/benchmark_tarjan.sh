@@ -0,0 +1,69 @@
+#!/bin/bash
+
+# Runs every LTL query of every model in a directory of models laid out as
+# test_models (<model>/model.pnml and <model>/query.xml) with the Tarjan
+# algorithm, and reports the time of each query and the explored states per
+# second. Small queries mostly show the cost of setting up the search.
+# If a reference binary is given, e.g. one built from a revision with another
+# hash table for the search stack, it is run as well and must give the same
+# answers, a query where it does not is reported and the script exits with 1.
+
+B=$1
+R=$2
+D=$3
+F=$4
+O="$5"
+
+if [ -z "$B" ] ; then
+	echo "Missing binary"
+	exit 2
+fi
+if [ -z "$D" ] ; then
+	echo "No model directory given, using test_models/LTL"
+	D=test_models/LTL
+fi
+if [ -z "$F" ] ; then
+	echo "Missing output"
+	exit 2
+fi
+
+# prints the answer, the explored states and the seconds it took
+check() {
+	start=$(date +%s.%N)
+	res=$(eval "$1 $O -ltl tarjan -x $2 $3 $4")
+	end=$(date +%s.%N)
+	answer=$(echo "$res" | grep "Query is" | sed -e 's/.*Query is //' -e 's/ /_/g')
+	explored=$(echo "$res" | grep "explored states:" | head -n 1 | awk '{ print $3 }')
+	echo "$answer ${explored:-0} $(echo "$end - $start" | bc -l)"
+}
+
+echo "model,query,answer,explored states,seconds,states per second,reference seconds" > $F
+FAILED=0
+for f in $(ls $D) ; do
+	M="$D/$f/model.pnml"
+	Q="$D/$f/query.xml"
+	if [ ! -f "$M" ] || [ ! -f "$Q" ] ; then
+		continue
+	fi
+	NP=$(grep "<property>" $Q | wc -l)
+	for q in $(seq 1 $NP) ; do
+		read answer explored time <<< $(check "$B" $q $M $Q)
+		if [ -z "$answer" ] ; then
+			continue
+		fi
+		rate=$(echo "$explored / $time" | bc -l | xargs printf "%.0f")
+		line="$f,$q,$answer,$explored,$time,$rate"
+		echo "$f:$q: $answer, $explored states in $time seconds"
+		if [ ! -z "$R" ] ; then
+			read ranswer rexplored rtime <<< $(check "$R" $q $M $Q)
+			if [ "$answer" != "$ranswer" ] ; then
+				echo "$f:$q: $answer, reference: $ranswer"
+				FAILED=1
+			fi
+			line="$line,$rtime"
+			echo "$f:$q: reference $rtime seconds"
+		fi
+		echo "$line" >> $F
+	done
+done
+exit $FAILED
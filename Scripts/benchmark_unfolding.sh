@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# Reports the unfolding time of every colored model in a directory of models
+# laid out as test_models (<model>/model.pnml and <model>/query.xml),
+# e.g. the colored models of the MCC. Uncolored models are skipped.
+
+B=$1
+D=$2
+F=$3
+O="$4"
+
+if [ -z "$B" ] ; then
+	echo "Missing binary"
+	exit
+fi
+if [ -z "$D" ] ; then
+	echo "No model directory given, using test_models"
+	D=test_models
+fi
+if [ -z "$F" ] ; then
+	echo "Missing output"
+	exit
+fi
+
+echo "model,unfolded transitions,unfold time" > $F
+TOTAL=0
+for f in $(ls $D) ; do
+	Q="$D/$f/query.xml"
+	if [ ! -f "$Q" ] ; then
+		Q=$(ls $D/$f/*.xml 2> /dev/null | head -n 1)
+	fi
+	if [ ! -f "$D/$f/model.pnml" ] || [ -z "$Q" ] ; then
+		continue
+	fi
+	res=$(eval "$B $O --noverify -x 1 $D/$f/model.pnml $Q")
+	time=$(echo "$res" | grep "Unfolded in" | awk '{ print $3 }')
+	if [ -z "$time" ] ; then
+		continue
+	fi
+	transitions=$(echo "$res" | grep "Size of unfolded net" | awk '{ print $7 }')
+	echo "$f: $transitions transitions in $time seconds"
+	echo "$f,$transitions,$time" >> $F
+	TOTAL=$(echo "$TOTAL + $time" | bc -l)
+done
+echo "Total unfold time: $TOTAL seconds"
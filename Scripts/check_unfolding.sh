@@ -0,0 +1,64 @@
+#!/bin/bash
+
+# Checks the unfolding of every colored model in a directory of models laid
+# out as test_models (<model>/model.pnml and <model>/query.xml).
+# The net unfolded with one thread must be identical to the one unfolded with
+# the given number of threads. If a reference binary is given, e.g. one built
+# from a revision evaluating the colored expressions without compiling them,
+# its unfolded net must be identical too.
+# Exits with 1 if any model fails.
+
+B=$1
+D=$2
+J=$3
+R=$4
+O="$5"
+
+if [ -z "$B" ] ; then
+	echo "Missing binary"
+	exit 2
+fi
+if [ -z "$D" ] ; then
+	echo "No model directory given, using test_models/Colored"
+	D=test_models/Colored
+fi
+if [ -z "$J" ] ; then
+	echo "No number of threads given, using 4"
+	J=4
+fi
+
+TMP=$(mktemp -d)
+trap "rm -rf $TMP" EXIT
+
+FAILED=0
+for f in $(ls $D) ; do
+	Q="$D/$f/query.xml"
+	if [ ! -f "$D/$f/model.pnml" ] || [ ! -f "$Q" ] ; then
+		continue
+	fi
+	size=$(eval "$B $O --noverify -x 1 -z 1 --write-unfolded-net $TMP/1.pnml $D/$f/model.pnml $Q" | grep "Size of unfolded net")
+	if [ -z "$size" ] ; then
+		continue
+	fi
+	eval "$B $O --noverify -x 1 -z $J --write-unfolded-net $TMP/$J.pnml $D/$f/model.pnml $Q" > /dev/null
+	if ! cmp -s $TMP/1.pnml $TMP/$J.pnml ; then
+		echo "$f: unfolded net differs between 1 and $J threads"
+		FAILED=1
+		continue
+	fi
+	if [ ! -z "$R" ] ; then
+		ref=$(eval "$R $O --noverify -x 1 --write-unfolded-net $TMP/ref.pnml $D/$f/model.pnml $Q" | grep "Size of unfolded net")
+		if [ "$size" != "$ref" ] ; then
+			echo "$f: $size, reference: $ref"
+			FAILED=1
+			continue
+		fi
+		if ! cmp -s $TMP/1.pnml $TMP/ref.pnml ; then
+			echo "$f: unfolded net differs from the reference"
+			FAILED=1
+			continue
+		fi
+	fi
+	echo "$f: OK"
+done
+exit $FAILED
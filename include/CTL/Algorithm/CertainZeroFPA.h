@@ -13,7 +13,8 @@ namespace Algorithm {
 class CertainZeroFPA : public FixedPointAlgorithm
 {
 public:
-    CertainZeroFPA(PetriEngine::Reachability::Strategy type) : FixedPointAlgorithm(type)
+    CertainZeroFPA(PetriEngine::Reachability::Strategy type,
+                   uint32_t dfs_ratio = 0) : FixedPointAlgorithm(type, dfs_ratio)
     {
     }
     virtual ~CertainZeroFPA()
@@ -30,6 +31,9 @@ protected:
     void finalAssign(DependencyGraph::Edge *e, DependencyGraph::Assignment a);
     void explore(DependencyGraph::Configuration *c);
 
+    // successors of the configuration being explored
+    std::vector<DependencyGraph::Edge*> _succs;
+
 };
 }
 #endif // CERTAINZEROFPA_H
@@ -10,7 +10,8 @@ namespace Algorithm {
 class FixedPointAlgorithm {
 public:
     virtual bool search(DependencyGraph::BasicDependencyGraph &graph) =0;
-    FixedPointAlgorithm(PetriEngine::Reachability::Strategy type);
+    FixedPointAlgorithm(PetriEngine::Reachability::Strategy type,
+                        uint32_t dfs_ratio = 0);
     virtual ~FixedPointAlgorithm(){}
 
     size_t processedEdges() const { return _processedEdges; }
@@ -11,7 +11,8 @@ class LocalFPA : public FixedPointAlgorithm
 
     // FixedPointAlgorithm interface
 public:
-    LocalFPA(PetriEngine::Reachability::Strategy type) : FixedPointAlgorithm(type)
+    LocalFPA(PetriEngine::Reachability::Strategy type,
+             uint32_t dfs_ratio = 0) : FixedPointAlgorithm(type, dfs_ratio)
     {
     }
     virtual ~LocalFPA (){}
@@ -24,6 +25,9 @@ protected:
     void explore(DependencyGraph::Configuration *c);
     void addDependency(DependencyGraph::Edge *e,
                           DependencyGraph::Configuration *target);
+
+    // successors of the configuration being explored
+    std::vector<DependencyGraph::Edge*> _succs;
 };
 }
 #endif // LOCALFPA_H
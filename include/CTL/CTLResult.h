@@ -21,6 +21,8 @@ struct CTLResult {
     size_t processedNegationEdges = 0;
     size_t exploredConfigurations = 0;
     size_t numberOfEdges = 0;
+    size_t reclaimedConfigurations = 0;
+    size_t reusedMarkings = 0;
 #ifdef VERIFYPNDIST
     size_t numberOfRoundsComputingDistance = 0;
     size_t numberOfTokensReceived = 0;
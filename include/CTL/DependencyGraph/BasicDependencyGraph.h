@@ -13,7 +13,8 @@ class Edge;
 class BasicDependencyGraph {
 
 public:
-    virtual std::vector<Edge*> successors(Configuration *c) =0;
+    // clears succs and fills it with the outgoing edges of c
+    virtual void successors(Configuration *c, std::vector<Edge*>& succs) =0;
     virtual Configuration *initialConfiguration() =0;
     virtual void release(Edge* e) = 0;
     virtual void cleanUp() =0;
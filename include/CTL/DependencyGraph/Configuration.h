@@ -7,7 +7,6 @@
 #include <cstdio>
 #include <iostream>
 #include <vector>
-#include <forward_list>
 
 namespace DependencyGraph {
 
@@ -16,13 +15,16 @@ class Edge;
 class Configuration
 {
 public:
-    std::forward_list<Edge*> dependency_set;   
+    // sorted by address
+    SmallVector<Edge*, 1> dependency_set;
     uint32_t nsuccs = 0;
 private:
     uint32_t distance = 0;
     void setDistance(uint32_t value) { distance = value; }
 public:
     int8_t assignment = UNKNOWN;
+    // set while collecting garbage if a live edge refers to the configuration
+    bool gc_mark = false;
     Configuration() {}
     uint32_t getDistance() const { return distance; }
     bool isDone() const { return assignment == ONE || assignment == CZERO; }
@@ -6,7 +6,7 @@
 #include <string>
 #include <algorithm>
 #include <cassert>
-#include <forward_list>
+#include "SmallVector.h"
 
 namespace DependencyGraph {
 
@@ -16,7 +16,8 @@ enum Assignment {
 };
 
 class Edge {
-    typedef std::forward_list<Configuration*> container;
+    // most edges have one or two targets
+    typedef SmallVector<Configuration*, 2> container;
 public:
     Edge(){}
     Edge(Configuration &t_source) : source(&t_source) {}
@@ -24,12 +25,14 @@ public:
     void addTarget(Configuration* conf)
     {
         assert(conf);
-        targets.push_front(conf);
+        targets.push_back(conf);
         //++children;
     }
     
     container targets;    
     Configuration* source;
+    // lower is more promising, used by the heuristic search
+    uint32_t weight = 0;
     uint8_t status = 0;
     bool processed = false;
     bool is_negated = false;
@@ -0,0 +1,101 @@
+#ifndef SMALLVECTOR_H
+#define SMALLVECTOR_H
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace DependencyGraph {
+
+/*
+ * Vector of trivially copyable values keeping up to N of them inline and
+ * the rest in a heap block. clear() keeps the block, so containers that
+ * are recycled (edges) stop allocating once they have grown. All-zero
+ * memory is a valid empty vector, as the edges live in a linked_bucket_t
+ * which memsets its storage.
+ */
+template<typename T, uint32_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector only moves its elements with memcpy");
+public:
+    SmallVector() {}
+    SmallVector(const SmallVector&) = delete;
+    SmallVector& operator=(const SmallVector&) = delete;
+    ~SmallVector()
+    {
+        if(onHeap()) free(_heap);
+    }
+
+    T* begin() { return data(); }
+    T* end() { return data() + _size; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + _size; }
+    T& operator[](uint32_t i) { assert(i < _size); return data()[i]; }
+    uint32_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    void push_back(const T& value)
+    {
+        if(_size == capacity()) grow();
+        data()[_size++] = value;
+    }
+
+    T* insert(T* pos, const T& value)
+    {
+        auto i = pos - begin();
+        if(_size == capacity()) grow();
+        T* d = data();
+        memmove(&d[i + 1], &d[i], (_size - i) * sizeof(T));
+        d[i] = value;
+        ++_size;
+        return &d[i];
+    }
+
+    // keeps the order of the remaining elements
+    T* erase(T* pos)
+    {
+        memmove(pos, pos + 1, (end() - pos - 1) * sizeof(T));
+        --_size;
+        return pos;
+    }
+
+    void clear() { _size = 0; }
+
+    void shrink_to_fit()
+    {
+        if(!onHeap() || _size > N) return;
+        T* old = _heap;
+        memcpy(_inline, old, _size * sizeof(T));
+        free(old);
+        _capacity = 0;
+    }
+
+private:
+    // _capacity is zero while the elements are inline
+    bool onHeap() const { return _capacity != 0; }
+    uint32_t capacity() const { return onHeap() ? _capacity : N; }
+    T* data() { return onHeap() ? _heap : _inline; }
+    const T* data() const { return onHeap() ? _heap : _inline; }
+
+    void grow()
+    {
+        uint32_t ncap = capacity() * 2;
+        T* block = static_cast<T*>(malloc(ncap * sizeof(T)));
+        memcpy(block, data(), _size * sizeof(T));
+        if(onHeap()) free(_heap);
+        _heap = block;
+        _capacity = ncap;
+    }
+
+    union {
+        T* _heap;
+        T _inline[N];
+    };
+    uint32_t _size = 0;
+    uint32_t _capacity = 0;
+};
+
+}
+#endif // SMALLVECTOR_H
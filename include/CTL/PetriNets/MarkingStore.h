@@ -0,0 +1,43 @@
+#ifndef MARKINGSTORE_H
+#define MARKINGSTORE_H
+
+#include <ptrie/ptrie_stable.h>
+
+#include <utility>
+
+namespace PetriNets {
+
+// The encoded markings seen by the dependency graphs of a run. The graphs
+// of consecutive queries on the same net share a store, so markings found
+// by an earlier query are not encoded into a new trie again. The ids are
+// stable, the configurations using them are kept by each graph.
+// Markings are never removed, so a shared store holds the markings of all
+// the queries it was used for, where separate stores only hold those of the
+// query being solved.
+// Not thread-safe; concurrent graphs need a store each.
+class MarkingStore {
+public:
+    using ptrie_t = ptrie::set_stable<ptrie::uchar,17,128,4>;
+
+    std::pair<bool, size_t> insert(const ptrie::uchar* data, size_t length)
+    {
+        auto res = _trie.insert(data, length);
+        if(res.first) _bytes += length;
+        return res;
+    }
+
+    void unpack(size_t id, ptrie::uchar* destination)
+    {
+        _trie.unpack(id, destination);
+    }
+
+    // bytes of encoded markings inserted
+    size_t bytes() const { return _bytes; }
+
+private:
+    ptrie_t _trie;
+    size_t _bytes = 0;
+};
+
+}
+#endif // MARKINGSTORE_H
@@ -1,13 +1,12 @@
 #ifndef ONTHEFLYDG_H
 #define ONTHEFLYDG_H
 
-#include <functional>
 #include <stack>
-#include <ptrie/ptrie_map.h>
 
 #include "CTL/DependencyGraph/BasicDependencyGraph.h"
 #include "CTL/DependencyGraph/Configuration.h"
 #include "CTL/DependencyGraph/Edge.h"
+#include "MarkingStore.h"
 #include "PetriConfig.h"
 #include "PetriParse/PNMLParser.h"
 #include "PetriEngine/PQL/PQL.h"
@@ -15,6 +14,8 @@
 #include "PetriEngine/Structures/linked_bucket.h"
 #include "PetriEngine/ReducingSuccessorGenerator.h"
 
+#include <unordered_map>
+
 namespace PetriNets {
 class OnTheFlyDG : public DependencyGraph::BasicDependencyGraph
 {
@@ -22,12 +23,14 @@ public:
     using Condition = PetriEngine::PQL::Condition;
     using Condition_ptr = PetriEngine::PQL::Condition_ptr;
     using Marking = PetriEngine::Structures::State;
-    OnTheFlyDG(PetriEngine::PetriNet *t_net, bool partial_order);
+    // markings are shared with other graphs using the same store
+    OnTheFlyDG(PetriEngine::PetriNet *t_net, bool partial_order,
+               std::shared_ptr<MarkingStore> store = nullptr);
 
     virtual ~OnTheFlyDG();
 
     //Dependency graph interface
-    virtual std::vector<DependencyGraph::Edge*> successors(DependencyGraph::Configuration *c) override;
+    virtual void successors(DependencyGraph::Configuration *c, std::vector<DependencyGraph::Edge*>& succs) override;
     virtual DependencyGraph::Configuration *initialConfiguration() override;
     virtual void cleanUp() override;
     void setQuery(const Condition_ptr& query);
@@ -41,9 +44,21 @@ public:
     }
 
 
+    // Configurations with a final assignment which no live edge refers to
+    // are reclaimed whenever the estimated size of the graph exceeds the
+    // limit (in bytes, 0 disables it). The markings are kept.
+    void setMemoryLimit(size_t bytes) { _memoryLimit = bytes; _gcThreshold = bytes; }
+
+    // weigh the edges with Condition::distance of the formula they lead to,
+    // evaluated on the marking they lead to (for the heuristic search)
+    void setDistances(bool enable) { _distances = enable; }
+
     //stats
     size_t configurationCount() const;
     size_t markingCount() const;
+    size_t reclaimedCount() const { return _reclaimedCount; }
+    // markings of this graph which were already in the store
+    size_t reusedMarkingCount() const { return _reusedCount; }
     
     Condition::Result initialEval();
 
@@ -67,14 +82,12 @@ protected:
     {
         return fastEval(query.get(), unfolded);
     }
-    void nextStates(Marking& t_marking, Condition*,
-    std::function<void ()> pre, 
-    std::function<bool (Marking&)> foreach, 
-    std::function<void ()> post);
-    template<typename T>
-    void dowork(T& gen, bool& first, 
-    std::function<void ()>& pre, 
-    std::function<bool (Marking&)>& foreach)
+    // pre() is called before the first successor and post() after the last,
+    // foreach(marking) returns false to stop the enumeration
+    template<typename Pre, typename Foreach, typename Post>
+    void nextStates(Marking& t_marking, Condition*, Pre&& pre, Foreach&& foreach, Post&& post);
+    template<typename T, typename Pre, typename Foreach>
+    void dowork(T& gen, bool& first, Pre& pre, Foreach& foreach)
     {
         gen.prepare(&query_marking);
 
@@ -94,18 +107,43 @@ protected:
         return createConfiguration(marking, own, query.get());
     }
     size_t createMarking(Marking &marking);
+    size_t memoryUsage();
+    void collectGarbage();
     void markingStats(const uint32_t* marking, size_t& sum, bool& allsame, uint32_t& val, uint32_t& active, uint32_t& last);
     
     DependencyGraph::Edge* newEdge(DependencyGraph::Configuration &t_source, uint32_t weight);
+    uint32_t edgeWeight(Condition* cond, PetriEngine::PQL::DistanceContext& context);
+    uint32_t edgeWeight(const Condition_ptr& cond, PetriEngine::PQL::DistanceContext& context)
+    {
+        return edgeWeight(cond.get(), context);
+    }
 
     std::stack<DependencyGraph::Edge*> recycle;
-    ptrie::map<ptrie::uchar, std::vector<PetriConfig*> > trie;
+    std::shared_ptr<MarkingStore> _store;
+    // the markings of the store used by this graph are numbered densely, so the
+    // tables below only grow with them and not with the markings of other graphs.
+    // Configurations refer to markings by this number.
+    std::unordered_map<size_t, size_t> _local;
+    // id in the store and configurations of every marking of this graph
+    std::vector<size_t> _markings;
+    std::vector<std::vector<PetriConfig*> > _configs;
+    size_t _reusedCount = 0;
     linked_bucket_t<DependencyGraph::Edge,1024*10>* edge_alloc = nullptr;
 
     // Problem  with linked bucket and complex constructor
     linked_bucket_t<char[sizeof(PetriConfig)], 1024*1024>* conf_alloc = nullptr;
     
+    // reclaimed configurations, reused before allocating new ones
+    std::vector<PetriConfig*> _freeConfigs;
+    size_t _memoryLimit = 0;
+    size_t _gcThreshold = 0;
+    size_t _reclaimedCount = 0;
+    bool _distances = false;
+
     PetriEngine::ReducingSuccessorGenerator _redgen;
+    PetriEngine::SuccessorGenerator _gen;
+    // scratch space of successors()
+    std::vector<Condition*> _conds;
     bool _partial_order = false;
 
 };
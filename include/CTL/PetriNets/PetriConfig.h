@@ -20,6 +20,7 @@ public:
         DependencyGraph::Configuration(), marking(t_marking), query(t_query) {
     }
 
+    // number of the marking within the graph owning the configuration
     size_t marking;
     Condition *query;
 
@@ -8,22 +8,42 @@
 #ifndef HEURISTICSEARCH_H
 #define HEURISTICSEARCH_H
 
+#include <algorithm>
 #include <vector>
 #include "CTL/DependencyGraph/Edge.h"
 #include "SearchStrategy.h"
 
 namespace SearchStrategy {
 
-// A custom search strategy that should ensure as little overhead as possible
-// while running sequential computation.
+// Best-first search on the weight of the edges (the distance of the
+// subformula the edge leads to), newest first among equal weights.
+// dfs_ratio percent of the edges are instead taken in depth-first order.
 
 class HeuristicSearch : public SearchStrategy {
+public:
+    HeuristicSearch(uint32_t dfs_ratio = 0) : _dfs_ratio(std::min<uint32_t>(dfs_ratio, 100)) {}
 
 protected:
     size_t Wsize() const;
     void pushToW(DependencyGraph::Edge* edge);
     DependencyGraph::Edge* popFromW();
+
+private:
+    struct weighted_t {
+        uint32_t weight;
+        size_t slot;
+        DependencyGraph::Edge* edge;
+    };
+    static bool heapOrder(const weighted_t& a, const weighted_t& b);
+    void compact();
+
+    // edges in push order, popped ones are nullptr
     std::vector<DependencyGraph::Edge*> W;
+    // heap on weight over the slots of W, may refer to popped slots
+    std::vector<weighted_t> _heap;
+    size_t _live = 0;
+    uint32_t _dfs_ratio;
+    uint32_t _credit = 0;
 };
 
 }   // end SearchStrategy
@@ -49,7 +49,7 @@ namespace LTL {
 //            successorGenerator = std::make_unique<ProductSucGen<SuccessorGen, Spooler...>>(net, buchi, successorGen, std::move(spooler)...);
         }
 
-        void setOptions(const options_t &options) {
+        virtual void setOptions(const options_t &options) {
             traceLevel = options.trace;
             shortcircuitweak = options.ltluseweak;
             if (traceLevel != TraceLevel::None) {
@@ -62,6 +62,9 @@ namespace LTL {
 
         virtual bool isSatisfied() = 0;
 
+        // false if not finding a counter-example does not prove the formula
+        virtual bool isComplete() const { return true; }
+
         virtual ~ModelChecker() = default;
 
         virtual void printStats(std::ostream &os) = 0;
@@ -79,7 +82,7 @@ namespace LTL {
 
         virtual void _printStats(std::ostream &os, const LTL::Structures::ProductStateSetInterface &stateSet)
         {
-            std::cout << "STATS:\n"
+            os << "STATS:\n"
                       << "\tdiscovered states: " << stateSet.discovered() << std::endl
                       << "\texplored states:   " << stats.explored << std::endl
                       << "\texpanded states:   " << stats.expanded << std::endl
@@ -50,7 +50,7 @@ namespace LTL {
         NestedDepthFirstSearch(const PetriEngine::PetriNet *net, const PetriEngine::PQL::Condition_ptr &query,
                                const Structures::BuchiAutomaton &buchi, SucGen *gen, const bool print_trace, int kbound, const PetriEngine::Reducer* reducer)
                 : ModelChecker<ProductSuccessorGenerator, SucGen>(net, query, buchi, gen, reducer),
-                  _states(net, kbound), _print_trace(print_trace) {}
+                  _states(net, kbound, buchi._buchi->num_states()), _print_trace(print_trace) {}
 
         bool isSatisfied() override;
 
@@ -61,7 +61,7 @@ namespace LTL {
         std::pair<bool,size_t> mark(State& state, uint8_t);
 
 
-        LTL::Structures::BitProductStateSet<> _states;
+        LTL::Structures::BitProductStateSet _states;
 
         std::unordered_map<size_t, uint8_t> _markers;
         //std::vector<uint8_t> _markers;
@@ -0,0 +1,126 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_PARALLELNESTEDDEPTHFIRSTSEARCH_H
+#define VERIFYPN_PARALLELNESTEDDEPTHFIRSTSEARCH_H
+
+#include "ModelChecker.h"
+#include "LTL/Structures/ConcurrentProductStateSet.h"
+#include "LTL/SuccessorGeneration/ResumingSuccessorGenerator.h"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace LTL {
+
+    /**
+     * Multi-core nested DFS (CNDFS) as given in
+     * <p>
+     *   Sami Evangelista, Alfons Laarman, Laure Petrucci & Jaco van de Pol,<br>
+     *   Improved Multi-Core Nested Depth-First Search,<br>
+     *   https://doi.org/10.1007/978-3-642-33386-6_22
+     * </p>
+     * Every thread runs its own nested DFS on a shared product state set, visiting the
+     * successors of a state in a different order per thread. The red (nested) searches
+     * share the states they have finished with the other threads, which then skip them.
+     * The first thread to either find an accepting cycle or finish its search decides
+     * the answer. Traces are not supported.
+     */
+    class ParallelNestedDepthFirstSearch : public ModelChecker<ProductSuccessorGenerator, ResumingSuccessorGenerator> {
+    public:
+        ParallelNestedDepthFirstSearch(const PetriEngine::PetriNet *net, const PetriEngine::PQL::Condition_ptr &query,
+                                       const Structures::BuchiAutomaton &buchi, ResumingSuccessorGenerator *gen,
+                                       uint32_t threads, size_t seed, int kbound, const PetriEngine::Reducer *reducer);
+
+        bool isSatisfied() override;
+
+        void printStats(std::ostream &os) override;
+
+    private:
+        using State = LTL::Structures::ProductState;
+        using ProductGen = ProductSuccessorGenerator<ResumingSuccessorGenerator>;
+
+        struct shared_t {
+            // no accepting cycle goes through the state
+            std::atomic<bool> red{false};
+            // number of red searches started from the (accepting) state which are not finished
+            std::atomic<uint32_t> count{0};
+        };
+
+        using StateSet = Structures::ConcurrentProductStateSet<shared_t>;
+        using stateid_t = StateSet::stateid_t;
+
+        // colours local to a thread
+        static constexpr uint8_t CYAN = 1;
+        static constexpr uint8_t BLUE = 2;
+        static constexpr uint8_t PINK = 4;
+
+        struct successor_t {
+            stateid_t id;
+            shared_t *info;
+            bool accepting;
+        };
+
+        struct frame_t {
+            successor_t state;
+            std::vector<successor_t> successors;
+            size_t next = 0;
+            bool allred = true;
+            // successors[next - 1] was searched from this frame, its colour is not checked yet
+            bool pending = false;
+        };
+
+        struct worker_t {
+            worker_t(State &&parent, State &&working, size_t seed)
+                    : parent(std::move(parent)), working(std::move(working)), rng(seed) {}
+
+            std::unique_ptr<ResumingSuccessorGenerator> own_gen;
+            std::unique_ptr<ProductGen> own_product_gen;
+            ProductGen *gen = nullptr;
+            State parent;
+            State working;
+            std::default_random_engine rng;
+            std::unordered_map<stateid_t, uint8_t> colours;
+            std::vector<frame_t> blue_stack;
+            std::vector<frame_t> red_stack;
+            // states visited by the current red search
+            std::vector<successor_t> reds;
+            size_t explored = 0;
+            size_t expanded = 0;
+        };
+
+        void work(size_t tid, const std::vector<State> &initial);
+
+        bool blue(size_t tid, worker_t &w, const successor_t &root);
+
+        bool red(size_t tid, worker_t &w, const frame_t &root);
+
+        void expand(size_t tid, worker_t &w, frame_t &frame);
+
+        static frame_t &push(std::vector<frame_t> &stack, size_t depth, const successor_t &state);
+
+        std::unique_ptr<StateSet> _states;
+        std::vector<std::unique_ptr<worker_t>> _workers;
+        std::atomic<bool> _done{false};
+        std::atomic<bool> _violation{false};
+        int _kbound;
+    };
+}
+
+#endif //VERIFYPN_PARALLELNESTEDDEPTHFIRSTSEARCH_H
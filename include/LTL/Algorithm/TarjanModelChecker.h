@@ -22,12 +22,13 @@
 #include "LTL/Algorithm/ModelChecker.h"
 #include "LTL/Structures/ProductStateFactory.h"
 #include "LTL/Structures/BitProductStateSet.h"
+#include "LTL/Structures/BitstateProductStateSet.h"
+#include "LTL/Structures/StackHashTable.h"
 #include "LTL/SuccessorGeneration/ResumingSuccessorGenerator.h"
 #include "LTL/SuccessorGeneration/SpoolingSuccessorGenerator.h"
 
 #include <limits>
 #include <stack>
-#include <unordered_set>
 
 namespace LTL {
 
@@ -52,44 +53,48 @@ namespace LTL {
                            int kbound, const PetriEngine::Reducer* reducer,
                            std::unique_ptr<Spooler> &&...spooler)
                 : ModelChecker<ProductSucGen, SuccessorGen, Spooler...>(net, cond, buchi, successorGen, reducer, std::move(spooler)...),
-                  _seen(net, kbound)
+                  _kbound(kbound), _buchi_states(buchi._buchi->num_states()),
+                  _seen(std::make_unique<StateSet>(net, kbound, _buchi_states))
         {
-            if (buchi._buchi->num_states() > 65535) {
-                std::cerr << "Fatal error: cannot handle Büchi automata larger than 2^16 states\n";
-                exit(1);
+        }
+
+        void setOptions(const options_t &options) override
+        {
+            ModelChecker<ProductSucGen, SuccessorGen, Spooler...>::setOptions(options);
+            if constexpr (!SaveTrace) {
+                if (options.bitstate > 0) {
+                    _seen = std::make_unique<LTL::Structures::BitstateProductStateSet>(
+                            this->net, _kbound, _buchi_states, options.bitstate, options.bitstate_hashes);
+                }
             }
-            _chash.fill(std::numeric_limits<idx_t>::max());
         }
 
         bool isSatisfied() override;
 
+        bool isComplete() const override { return _seen->complete(); }
+
         void printStats(std::ostream &os) override
         {
-            this->_printStats(os, _seen);
+            this->_printStats(os, *_seen);
+            this->successorGenerator->printPORStats(os);
         }
 
     private:
         using State = LTL::Structures::ProductState;
         using idx_t = size_t;
-        // 64 MB hash table
-        static constexpr idx_t _hash_sz = 16777216;
 
-
-        using StateSet = std::conditional_t<SaveTrace, LTL::Structures::TraceableBitProductStateSet<>, LTL::Structures::BitProductStateSet<>>;
+        using StateSet = std::conditional_t<SaveTrace, LTL::Structures::TraceableBitProductStateSet, LTL::Structures::BitProductStateSet>;
         static constexpr bool _is_spooling = std::is_same_v<SuccessorGen, SpoolingSuccessorGenerator>;
 
-        StateSet _seen;
-        std::unordered_set<idx_t> _store;
-
-        // rudimentary hash table of state IDs. chash[hash(state)] is the top index in cstack
-        // corresponding to state. Collisions are resolved using linked list via CEntry::next.
-        std::array<idx_t, _hash_sz> _chash;
-        static_assert(sizeof(_chash) == (1U << 27U));
+        int _kbound;
+        size_t _buchi_states;
+        std::unique_ptr<LTL::Structures::ProductStateSetInterface> _seen;
+        // finished states, only needed when _seen is exact
+        Structures::FlatIdSet _store;
 
-        static inline idx_t hash(idx_t id)
-        {
-            return id % _hash_sz;
-        }
+        // hash table from marking IDs to the top index in cstack of a state with that marking.
+        // The states on cstack with the same marking (but different Büchi states) are linked via CEntry::next.
+        Structures::StackHashTable _chash;
 
         struct PlainCEntry {
             idx_t _lowlink;
@@ -21,6 +21,7 @@
 #include "LTL/LTLValidator.h"
 #include "LTL/Algorithm/TarjanModelChecker.h"
 #include "LTL/Algorithm/NestedDepthFirstSearch.h"
+#include "LTL/Algorithm/ParallelNestedDepthFirstSearch.h"
 #include "LTL/Simplification/SpotToPQL.h"
 #include "LTL/LTLToBuchi.h"
 
@@ -28,6 +28,17 @@ namespace LTL {
                         const std::string &queryName,
                         options_t &options,
                         const PetriEngine::Reducer* reducer);
+
+    /**
+     * Verifies the LTL queries with the given ids, reporting each result as it completes.
+     * With several cores the queries are verified concurrently, sharing the net.
+     */
+    void LTLMain(const PetriEngine::PetriNet *net,
+                 const std::vector<PetriEngine::PQL::Condition_ptr> &queries,
+                 const std::vector<std::string> &querynames,
+                 const std::vector<size_t> &ids,
+                 options_t &options,
+                 const PetriEngine::Reducer* reducer);
 }
 
 #endif //VERIFYPN_LTLMAIN_H
@@ -20,8 +20,10 @@
 
 #include "PetriEngine/Structures/StateSet.h"
 #include "LTL/Structures/ProductState.h"
+#include "LTL/Structures/FlatIdSet.h"
 #include <cstdint>
-#include <unordered_set>
+#include <cstdlib>
+#include <iostream>
 #include <unordered_map>
 
 namespace LTL::Structures {
@@ -48,6 +50,20 @@ namespace LTL::Structures {
             return std::make_pair(std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max());
         }
 
+        /**
+         * Mark a state as referenced by the search, it must remain decodable until released.
+         * Only relevant for sets that do not keep all states.
+         */
+        virtual void retain(stateid_t id) {}
+
+        virtual void release(stateid_t id) {}
+
+        // false if states can wrongly be reported as already seen
+        virtual bool complete() const { return true; }
+
+        // true if two distinct states retained by the search have been given the same id
+        virtual bool collision() const { return false; }
+
         virtual size_t discovered() const = 0;
 
         virtual size_t max_tokens() const = 0;
@@ -56,22 +72,35 @@ namespace LTL::Structures {
 
     };
 
+    /**
+     * @return the number of bits needed for the state number of an automaton with buchi_states states.
+     * Exits if the automaton has more than 2^32 states.
+     */
+    inline uint32_t buchi_bits(size_t buchi_states)
+    {
+        if (buchi_states > (size_t(1) << 32)) {
+            std::cerr << "Fatal error: cannot handle Büchi automata larger than 2^32 states\n";
+            exit(1);
+        }
+        uint32_t bits = 1;
+        while ((size_t(1) << bits) < buchi_states)
+            ++bits;
+        return bits;
+    }
+
     /**
      * Bit-hacking product state set for storing pairs (M, q) compactly in 64 bits.
-     * Allows for a max of 2^nbits Büchi states and 2^(64-nbits) markings without overflow.
-     * @tparam nbits the number of bits to allocate for Büchi state. Defaults to 16-bit. Max is 32-bit.
+     * The Büchi state takes as few bits as the automaton needs (at most 32), the
+     * marking ID the remaining ones. The product IDs seen are kept in a FlatIdSet.
      */
-    template<uint8_t nbits = 16>
     class BitProductStateSet : public ProductStateSetInterface {
     public:
-        explicit BitProductStateSet(const PetriEngine::PetriNet *net, int kbound = 0)
-                : markings(*net, kbound, net->numberOfPlaces())
+        BitProductStateSet(const PetriEngine::PetriNet *net, int kbound, size_t buchi_states)
+                : markings(*net, kbound, net->numberOfPlaces()),
+                  buchiShift(64 - buchi_bits(buchi_states)), markingMask((stateid_t(1) << buchiShift) - 1)
         {
         }
 
-        static_assert(nbits <= 32, "Only up to 2^32 Büchi states supported");
-        //using stateid_t = size_t;
-
         /**
          * bool success
          * size_t stateID; if error it is UINT64_MAX.
@@ -83,7 +112,7 @@ namespace LTL::Structures {
 
         stateid_t getProductId(size_t markingId, size_t buchiState) override
         {
-            return (buchiState << buchiShift) | (markingMask & markingId);
+            return (stateid_t(buchiState) << buchiShift) | (markingMask & markingId);
         }
 
         /**
@@ -99,10 +128,7 @@ namespace LTL::Structures {
                 return res;
             }
             const stateid_t product_id = getProductId(res.second, state.getBuchiState());
-
-            const auto[iter, is_new] = states.insert(product_id);
-            assert(iter != std::end(states));
-            return std::make_pair(is_new, product_id);
+            return std::make_pair(states.insert(product_id), product_id);
         }
 
         /**
@@ -113,14 +139,11 @@ namespace LTL::Structures {
          */
         bool decode(LTL::Structures::ProductState &state, stateid_t id) override
         {
-            const auto it = states.find(id);
-            if (it == std::cend(states)) {
+            if (!states.contains(id)) {
                 return false;
             }
-            auto marking_id = getMarkingId(*it);
-            auto buchi_state = getBuchiState(*it);
-            markings.decode(state, marking_id);
-            state.setBuchiState(buchi_state);
+            markings.decode(state, getMarkingId(id));
+            state.setBuchiState(getBuchiState(id));
             return true;
         }
 
@@ -130,30 +153,25 @@ namespace LTL::Structures {
         size_t max_tokens() const override { return markings.maxTokens(); }
 
     protected:
-        static constexpr auto markingMask = (1LL << (64 - nbits)) - 1;
-        static constexpr auto buchiMask = std::numeric_limits<size_t>::max() ^markingMask;
-        static constexpr auto buchiShift = 64 - nbits;
-
         PetriEngine::Structures::StateSet markings;
-        std::unordered_set<stateid_t> states;
-        static constexpr auto err_val = std::make_pair(false, std::numeric_limits<size_t>::max());
+        const uint32_t buchiShift;
+        const stateid_t markingMask;
+        FlatIdSet states;
 
         size_t _discovered = 0;
     };
 
-    template<uint8_t nbytes = 16>
-    class TraceableBitProductStateSet : public BitProductStateSet<nbytes> {
-        using stateid_t = typename BitProductStateSet<nbytes>::stateid_t;
+    class TraceableBitProductStateSet : public BitProductStateSet {
     public:
-        explicit TraceableBitProductStateSet(const PetriEngine::PetriNet *net, int kbound = 0)
-                : BitProductStateSet<nbytes>(net, kbound)
+        TraceableBitProductStateSet(const PetriEngine::PetriNet *net, int kbound, size_t buchi_states)
+                : BitProductStateSet(net, kbound, buchi_states)
         {
         }
 
         bool decode(ProductState &state, stateid_t id) override
         {
             _parent = id;
-            return BitProductStateSet<nbytes>::decode(state, id);
+            return BitProductStateSet::decode(state, id);
         }
 
         void setHistory(stateid_t id, size_t transition) override
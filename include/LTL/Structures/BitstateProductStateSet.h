@@ -0,0 +1,147 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_BITSTATEPRODUCTSTATESET_H
+#define VERIFYPN_BITSTATEPRODUCTSTATESET_H
+
+#include "LTL/Structures/BitProductStateSet.h"
+#include "PetriEngine/Structures/BitStateSet.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace LTL::Structures {
+
+    /**
+     * Product state set for the Tarjan model checker that only remembers visited states
+     * in a bitstate filter. A product ID is a hash of the encoded marking combined with the
+     * Büchi state (same layout as BitProductStateSet), so IDs of distinct states may collide
+     * and the search is possibly incomplete.
+     *
+     * Only states that are retained by the search (those on the Tarjan stacks) can be decoded.
+     * The state most recently added can be retained without being decoded first. Retaining it
+     * while a different state with the same ID is kept is reported by collision(), as the search
+     * can then no longer tell the two apart.
+     */
+    class BitstateProductStateSet : public ProductStateSetInterface {
+    public:
+        BitstateProductStateSet(const PetriEngine::PetriNet *net, int kbound, size_t buchi_states, uint32_t bits, uint32_t hashes)
+                : _net(net), _kbound(kbound), buchiShift(64 - buchi_bits(buchi_states)),
+                  markingMask((stateid_t(1) << buchiShift) - 1), _encoder(net->numberOfPlaces(), kbound), _filter(bits, hashes)
+        {
+        }
+
+        size_t getBuchiState(stateid_t id) override { return id >> buchiShift; }
+
+        size_t getMarkingId(stateid_t id) override { return id & markingMask; }
+
+        stateid_t getProductId(size_t markingId, size_t buchiState) override
+        {
+            return (stateid_t(buchiState) << buchiShift) | (markingMask & markingId);
+        }
+
+        result_t add(const LTL::Structures::ProductState &state) override
+        {
+            ++_discovered;
+            const auto marking = state.marking();
+            PetriEngine::MarkVal sum = 0;
+            bool allsame = true;
+            uint32_t val = 0;
+            uint32_t active = 0;
+            for (uint32_t i = 0; i < _net->numberOfPlaces(); ++i) {
+                if (marking[i] == 0) continue;
+                if (val != 0 && marking[i] != val) allsame = false;
+                val = std::max(marking[i], val);
+                ++active;
+                sum += marking[i];
+            }
+            _maxTokens = std::max(_maxTokens, sum);
+            if (_kbound != 0 && sum > static_cast<uint32_t>(_kbound)) {
+                return std::make_pair(false, std::numeric_limits<size_t>::max());
+            }
+
+            const auto length = _encoder.encode(marking, _encoder.getType(sum, active, allsame, val));
+            const auto raw = _encoder.scratchpad().const_raw();
+            const stateid_t id = getProductId(MurmurHash64A(raw, length, 0), state.getBuchiState());
+            _last_id = id;
+            _last.assign(raw, raw + length);
+            return std::make_pair(_filter.insert(&id, sizeof(id)), id);
+        }
+
+        bool decode(LTL::Structures::ProductState &state, stateid_t id) override
+        {
+            const auto it = _live.find(id);
+            if (it == std::end(_live)) {
+                return false;
+            }
+            _encoder.decode(state.marking(), it->second.encoding.data());
+            state.setBuchiState(getBuchiState(id));
+            return true;
+        }
+
+        void retain(stateid_t id) override
+        {
+            auto it = _live.find(id);
+            if (it != std::end(_live)) {
+                if (id == _last_id && it->second.encoding != _last) {
+                    _collision = true;
+                }
+                ++it->second.refs;
+                return;
+            }
+            assert(id == _last_id);
+            _live.emplace(id, live_t{1, _last});
+        }
+
+        void release(stateid_t id) override
+        {
+            auto it = _live.find(id);
+            assert(it != std::end(_live));
+            if (--it->second.refs == 0) {
+                _live.erase(it);
+            }
+        }
+
+        bool complete() const override { return false; }
+
+        bool collision() const override { return _collision; }
+
+        size_t discovered() const override { return _discovered; }
+
+        size_t max_tokens() const override { return _maxTokens; }
+
+    private:
+        struct live_t {
+            size_t refs;
+            std::vector<unsigned char> encoding;
+        };
+
+        const PetriEngine::PetriNet *_net;
+        int _kbound;
+        const uint32_t buchiShift;
+        const stateid_t markingMask;
+        AlignedEncoder _encoder;
+        PetriEngine::Structures::BitStateFilter _filter;
+        std::unordered_map<stateid_t, live_t> _live;
+        std::vector<unsigned char> _last;
+        stateid_t _last_id = std::numeric_limits<stateid_t>::max();
+        size_t _discovered = 0;
+        uint32_t _maxTokens = 0;
+        bool _collision = false;
+    };
+}
+
+#endif //VERIFYPN_BITSTATEPRODUCTSTATESET_H
@@ -57,14 +57,17 @@ namespace LTL::Structures {
 
         /**
          * Evaluate binary decision diagram (BDD) representation of transition guard in given state.
+         * The diagram is walked through the node ids, since copying or assigning bdd objects updates
+         * the reference counts of BuDDy, which are shared by all threads and not synchronized.
          */
-        bool guard_valid(PetriEngine::PQL::EvaluationContext &ctx, bdd bdd) const
+        bool guard_valid(PetriEngine::PQL::EvaluationContext &ctx, const bdd &cond) const
         {
             // IDs 0 and 1 are false and true atoms, respectively
             // More details in buddy manual ( http://buddy.sourceforge.net/manual/main.html )
-            while (bdd.id() > 1) {
+            int node = cond.id();
+            while (node > 1) {
                 // find variable to test, and test it
-                size_t var = bdd_var(bdd);
+                size_t var = bdd_var(node);
                 using PetriEngine::PQL::Condition;
                 Condition::Result res = ap_info.at(var).expression->evaluate(ctx);
                 switch (res) {
@@ -74,14 +77,14 @@ namespace LTL::Structures {
                         exit(1);
                         break;
                     case Condition::RFALSE:
-                        bdd = bdd_low(bdd);
+                        node = bdd_low(node);
                         break;
                     case Condition::RTRUE:
-                        bdd = bdd_high(bdd);
+                        node = bdd_high(node);
                         break;
                 }
             }
-            return bdd == bddtrue;
+            return node == 1;
         }
     };
 }
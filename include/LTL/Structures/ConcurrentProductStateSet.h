@@ -0,0 +1,108 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_CONCURRENTPRODUCTSTATESET_H
+#define VERIFYPN_CONCURRENTPRODUCTSTATESET_H
+
+#include "PetriEngine/Structures/ConcurrentStateSet.h"
+#include "LTL/Structures/BitProductStateSet.h"
+#include "LTL/Structures/ProductState.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace LTL::Structures {
+
+    /**
+     * Product state set which can be shared between threads. Markings are stored in a
+     * PetriEngine::Structures::ConcurrentStateSet and combined with the Büchi state into
+     * an id as in BitProductStateSet. Every product state carries a value of type T,
+     * constructed in place on insertion, which the search can use for state information
+     * shared between threads. The address of the value is stable, so it can be accessed
+     * without locking the set as long as T is itself thread-safe (i.e. atomics).
+     * @tparam T shared information per product state.
+     */
+    template<typename T>
+    class ConcurrentProductStateSet {
+    public:
+        using stateid_t = size_t;
+
+        struct result_t {
+            bool is_new;
+            stateid_t id;
+            T *info;
+        };
+
+        static constexpr stateid_t err_id = std::numeric_limits<stateid_t>::max();
+
+        ConcurrentProductStateSet(const PetriEngine::PetriNet *net, int kbound, size_t buchi_states,
+                                  uint32_t shards, uint32_t threads)
+                : _markings(*net, kbound, shards, threads), buchiShift(64 - buchi_bits(buchi_states)),
+                  markingMask((stateid_t(1) << buchiShift) - 1)
+        {
+            shards = std::max<uint32_t>(shards, 1);
+            for (uint32_t i = 0; i < shards; ++i)
+                _shards.emplace_back(std::make_unique<shard_t>());
+        }
+
+        /**
+         * Insert a product state into the state set.
+         * @param state the product state to insert.
+         * @param tid the thread inserting the state.
+         * @return whether the state is new, its id and its shared information.
+         * The id is err_id (and the information nullptr) if the state could not be stored.
+         */
+        result_t add(const ProductState &state, size_t tid)
+        {
+            auto res = _markings.add(state, tid);
+            if (res.second == err_id)
+                return result_t{false, err_id, nullptr};
+            const stateid_t id = (stateid_t(state.getBuchiState()) << buchiShift) | (res.second & markingMask);
+            auto &shard = *_shards[id % _shards.size()];
+            std::lock_guard<std::mutex> lock(shard._lock);
+            auto[it, is_new] = shard._info.try_emplace(id);
+            return result_t{is_new, id, &it->second};
+        }
+
+        void decode(ProductState &state, stateid_t id, size_t tid)
+        {
+            _markings.decode(state, id & markingMask, tid);
+            state.setBuchiState(id >> buchiShift);
+        }
+
+        size_t discovered() const { return _markings.discovered(); }
+
+        size_t max_tokens() const { return _markings.maxTokens(); }
+
+    private:
+        // nodes of an unordered_map are not moved when rehashing
+        struct shard_t {
+            std::mutex _lock;
+            std::unordered_map<stateid_t, T> _info;
+        };
+
+        PetriEngine::Structures::ConcurrentStateSet _markings;
+        const uint32_t buchiShift;
+        const stateid_t markingMask;
+        std::vector<std::unique_ptr<shard_t>> _shards;
+    };
+}
+
+#endif //VERIFYPN_CONCURRENTPRODUCTSTATESET_H
@@ -0,0 +1,71 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_FLATIDSET_H
+#define VERIFYPN_FLATIDSET_H
+
+#include "LTL/Structures/LinearProbingTable.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace LTL::Structures {
+
+    /**
+     * Insert-only open-addressing (linear probing) set of 64-bit ids, stored in a single
+     * array which is at most 3/4 full. An id costs 8 to 16 bytes, against a heap node and
+     * a bucket for std::unordered_set. The all-ones id is reserved to mark empty slots.
+     */
+    class FlatIdSet {
+        struct entry_t {
+            uint64_t key = std::numeric_limits<uint64_t>::max();
+        };
+        using table_t = LinearProbingTable<entry_t, 3, 4>;
+
+    public:
+        static constexpr uint64_t empty = table_t::empty;
+
+        explicit FlatIdSet(size_t capacity = 1024) : _table(capacity) {}
+
+        /**
+         * @return true if the id was not in the set before.
+         */
+        bool insert(uint64_t id)
+        {
+            assert(id != empty);
+            auto i = _table.find(id);
+            if (_table[i].key == id)
+                return false;
+            _table.insert(i, entry_t{id});
+            return true;
+        }
+
+        [[nodiscard]] bool contains(uint64_t id) const
+        {
+            return id != empty && _table[_table.find(id)].key == id;
+        }
+
+        [[nodiscard]] size_t size() const { return _table.size(); }
+
+        [[nodiscard]] size_t bytes() const { return _table.bytes(); }
+
+    private:
+        table_t _table;
+    };
+}
+
+#endif //VERIFYPN_FLATIDSET_H
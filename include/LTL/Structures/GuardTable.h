@@ -0,0 +1,152 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_GUARDTABLE_H
+#define VERIFYPN_GUARDTABLE_H
+
+#include "LTL/Structures/BuchiAutomaton.h"
+#include "PetriEngine/PQL/PQL.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace LTL::Structures {
+    /**
+     * The edges of a Büchi automaton with their guards compiled to flat decision
+     * diagrams over a dense numbering of the atomic propositions. The value of
+     * each proposition is memoized for the current marking, so propositions
+     * shared between guards and edges are evaluated once per marking.
+     * invalidate() must be called whenever the marking changes.
+     */
+    class GuardTable {
+    public:
+        struct edge_t {
+            uint32_t dst;
+            uint32_t guard;
+        };
+
+        explicit GuardTable(const BuchiAutomaton &aut)
+        {
+            // nodes 0 and 1 are the false and true terminals
+            _nodes.push_back(node_t{0, FALSE, FALSE});
+            _nodes.push_back(node_t{0, TRUE, TRUE});
+            std::unordered_map<int, uint32_t> compiled{{bddfalse.id(), FALSE}, {bddtrue.id(), TRUE}};
+            std::unordered_map<int, uint32_t> ap_index;
+            const auto nstates = aut._buchi->num_states();
+            _offsets.reserve(nstates + 1);
+            _offsets.push_back(0);
+            // same order as the successor iterator of the automaton
+            for (unsigned state = 0; state < nstates; ++state) {
+                for (auto &e : aut._buchi->out(state)) {
+                    _edges.push_back(edge_t{e.dst, compile(aut, e.cond, compiled, ap_index)});
+                }
+                _offsets.push_back(_edges.size());
+            }
+            _stamp.resize(_aps.size(), 0);
+            _value.resize(_aps.size(), 0);
+        }
+
+        [[nodiscard]] uint32_t first_edge(size_t state) const { return _offsets[state]; }
+
+        [[nodiscard]] uint32_t last_edge(size_t state) const { return _offsets[state + 1]; }
+
+        [[nodiscard]] const edge_t &edge(uint32_t i) const { return _edges[i]; }
+
+        /**
+         * Evaluate a compiled guard in the marking of ctx, which must be the
+         * marking seen since the last call to invalidate().
+         */
+        bool valid(uint32_t guard, const PetriEngine::PQL::EvaluationContext &ctx)
+        {
+            auto n = guard;
+            while (n > TRUE) {
+                const auto &node = _nodes[n];
+                n = holds(node.ap, ctx) ? node.high : node.low;
+            }
+            return n == TRUE;
+        }
+
+        void invalidate()
+        {
+            if (++_generation == 0) {
+                std::fill(_stamp.begin(), _stamp.end(), 0);
+                _generation = 1;
+            }
+        }
+
+    private:
+        static constexpr uint32_t FALSE = 0;
+        static constexpr uint32_t TRUE = 1;
+
+        struct node_t {
+            uint32_t ap;
+            uint32_t low;
+            uint32_t high;
+        };
+
+        uint32_t compile(const BuchiAutomaton &aut, bdd bdd, std::unordered_map<int, uint32_t> &compiled,
+                         std::unordered_map<int, uint32_t> &ap_index)
+        {
+            auto it = compiled.find(bdd.id());
+            if (it != compiled.end())
+                return it->second;
+            auto low = compile(aut, bdd_low(bdd), compiled, ap_index);
+            auto high = compile(aut, bdd_high(bdd), compiled, ap_index);
+            int var = bdd_var(bdd);
+            auto ap = ap_index.find(var);
+            if (ap == ap_index.end()) {
+                ap = ap_index.emplace(var, _aps.size()).first;
+                _aps.push_back(aut.ap_info.at(var).expression);
+            }
+            uint32_t id = _nodes.size();
+            _nodes.push_back(node_t{ap->second, low, high});
+            compiled.emplace(bdd.id(), id);
+            return id;
+        }
+
+        bool holds(uint32_t ap, const PetriEngine::PQL::EvaluationContext &ctx)
+        {
+            if (_stamp[ap] != _generation) {
+                using PetriEngine::PQL::Condition;
+                auto res = _aps[ap]->evaluate(ctx);
+                if (res == Condition::RUNKNOWN) {
+                    std::cerr << "Unexpected unknown answer from evaluating query!\n";
+                    assert(false);
+                    exit(1);
+                }
+                _value[ap] = res == Condition::RTRUE;
+                _stamp[ap] = _generation;
+            }
+            return _value[ap];
+        }
+
+        std::vector<PetriEngine::PQL::Condition_ptr> _aps;
+        std::vector<node_t> _nodes;
+        // the edges of state s are _edges[_offsets[s]] ... _edges[_offsets[s+1]-1]
+        std::vector<uint32_t> _offsets;
+        std::vector<edge_t> _edges;
+        // _value[ap] is only valid for the current marking if _stamp[ap] == _generation
+        std::vector<uint32_t> _stamp;
+        std::vector<uint8_t> _value;
+        uint32_t _generation = 1;
+    };
+}
+
+#endif //VERIFYPN_GUARDTABLE_H
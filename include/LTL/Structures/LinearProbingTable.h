@@ -0,0 +1,124 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_LINEARPROBINGTABLE_H
+#define VERIFYPN_LINEARPROBINGTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace LTL::Structures {
+
+    /**
+     * Open-addressing (linear probing) table of entries with a 64-bit key member, the
+     * all-ones key marks empty slots. The table doubles when more than LoadNum/LoadDen
+     * of it is used. Removal shifts the following entries back instead of leaving
+     * tombstones, so probe sequences stay short when the table shrinks and grows again.
+     */
+    template<typename Entry, size_t LoadNum, size_t LoadDen>
+    class LinearProbingTable {
+    public:
+        static constexpr uint64_t empty = std::numeric_limits<uint64_t>::max();
+
+        explicit LinearProbingTable(size_t capacity)
+        {
+            uint32_t bits = 4;
+            while ((size_t(1) << bits) < capacity)
+                ++bits;
+            resize(bits);
+        }
+
+        /**
+         * @return the slot of key, or the empty slot it would be inserted in.
+         */
+        [[nodiscard]] size_t find(uint64_t key) const
+        {
+            auto i = slot(key);
+            while (_table[i].key != key && _table[i].key != empty)
+                i = (i + 1) & _mask;
+            return i;
+        }
+
+        Entry &operator[](size_t i) { return _table[i]; }
+
+        const Entry &operator[](size_t i) const { return _table[i]; }
+
+        /**
+         * Put entry in the empty slot i returned by find, the slots are invalidated.
+         */
+        void insert(size_t i, const Entry &entry)
+        {
+            _table[i] = entry;
+            if (++_size * LoadDen > _table.size() * LoadNum)
+                resize(_bits + 1);
+        }
+
+        /**
+         * Empty the used slot i, the slots are invalidated.
+         */
+        void erase(size_t i)
+        {
+            // move entries back over the hole unless that would put them before their slot
+            for (auto j = (i + 1) & _mask; _table[j].key != empty; j = (j + 1) & _mask) {
+                auto home = slot(_table[j].key);
+                if (((j - home) & _mask) >= ((j - i) & _mask)) {
+                    _table[i] = _table[j];
+                    i = j;
+                }
+            }
+            _table[i] = Entry{};
+            --_size;
+        }
+
+        [[nodiscard]] size_t size() const { return _size; }
+
+        [[nodiscard]] size_t capacity() const { return _table.size(); }
+
+        [[nodiscard]] size_t bytes() const { return _table.size() * sizeof(Entry); }
+
+    private:
+        // ids are often consecutive, Fibonacci hashing spreads them over the table
+        [[nodiscard]] size_t slot(uint64_t key) const
+        {
+            return (key * UINT64_C(11400714819323198485)) >> (64 - _bits);
+        }
+
+        void resize(uint32_t bits)
+        {
+            std::vector<Entry> old(size_t(1) << bits);
+            old.swap(_table);
+            _bits = bits;
+            _mask = (size_t(1) << bits) - 1;
+            for (auto &e : old) {
+                if (e.key == empty)
+                    continue;
+                auto i = slot(e.key);
+                while (_table[i].key != empty)
+                    i = (i + 1) & _mask;
+                _table[i] = e;
+            }
+        }
+
+        std::vector<Entry> _table;
+        size_t _mask = 0;
+        uint32_t _bits = 0;
+        size_t _size = 0;
+    };
+}
+
+#endif //VERIFYPN_LINEARPROBINGTABLE_H
@@ -0,0 +1,82 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_STACKHASHTABLE_H
+#define VERIFYPN_STACKHASHTABLE_H
+
+#include "LTL/Structures/LinearProbingTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace LTL::Structures {
+
+    /**
+     * Open-addressing (linear probing) map between ids, used to index the states on the
+     * stack of a search. The table doubles when it is half full, so its size follows the
+     * deepest stack seen rather than the size of the state space.
+     */
+    class StackHashTable {
+    public:
+        static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+        explicit StackHashTable(size_t capacity = 1024) : _table(capacity) {}
+
+        /**
+         * @return the value of key or none if the key is not in the table.
+         */
+        [[nodiscard]] size_t find(size_t key) const
+        {
+            return _table[_table.find(key)].value;
+        }
+
+        /**
+         * Insert key, or overwrite its value if it is present.
+         */
+        void set(size_t key, size_t value)
+        {
+            auto i = _table.find(key);
+            if (_table[i].key == key)
+                _table[i].value = value;
+            else
+                _table.insert(i, entry_t{key, value});
+        }
+
+        void erase(size_t key)
+        {
+            auto i = _table.find(key);
+            if (_table[i].key == key)
+                _table.erase(i);
+        }
+
+        [[nodiscard]] size_t size() const { return _table.size(); }
+
+        [[nodiscard]] size_t capacity() const { return _table.capacity(); }
+
+    private:
+        struct entry_t {
+            uint64_t key = none;
+            size_t value = none;
+        };
+
+        static_assert(none == LinearProbingTable<entry_t, 1, 2>::empty, "ids must be 64-bit");
+
+        LinearProbingTable<entry_t, 1, 2> _table;
+    };
+}
+
+#endif //VERIFYPN_STACKHASHTABLE_H
@@ -0,0 +1,105 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_STUBBORNSETCACHE_H
+#define VERIFYPN_STUBBORNSETCACHE_H
+
+#include "PetriEngine/PetriNet.h"
+#include "LTL/SuccessorGeneration/SuccessorSpooler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace LTL::Structures {
+
+    /**
+     * Direct-mapped cache of the transitions a spooler returned for a marking and guard class
+     * (see SuccessorSpooler::guard_class). A product state reached with the same marking as a
+     * recently expanded state, but a Büchi state of the same class, reuses its stubborn set
+     * instead of computing the closure again. The cache holds a bounded number of entries,
+     * each with a copy of its marking, and a new entry replaces the one in its slot.
+     */
+    class StubbornSetCache {
+    public:
+        explicit StubbornSetCache(const PetriEngine::PetriNet &net, size_t budget = 16 * 1024 * 1024)
+                : _nplaces(net.numberOfPlaces())
+        {
+            const size_t entry = sizeof(entry_t) + (_nplaces + 16) * sizeof(PetriEngine::MarkVal);
+            size_t slots = 16;
+            while (slots < (size_t(1) << 14) && slots * 2 * entry <= budget)
+                slots *= 2;
+            _entries.resize(slots);
+        }
+
+        /**
+         * @return the transitions stored for the marking, or nullptr if they are not in the cache.
+         */
+        const std::vector<uint32_t> *find(const SuccessorSpooler *spooler, size_t guard_class,
+                                          const PetriEngine::MarkVal *marking)
+        {
+            _hash = hash(spooler, guard_class, marking);
+            _last = &_entries[_hash & (_entries.size() - 1)];
+            if (_last->spooler == spooler && _last->guard_class == guard_class && _last->hash == _hash &&
+                std::equal(marking, marking + _nplaces, _last->marking.begin())) {
+                return &_last->transitions;
+            }
+            return nullptr;
+        }
+
+        /**
+         * Store the transitions of the marking given to the last call of find, which must have missed.
+         */
+        void store(const SuccessorSpooler *spooler, size_t guard_class, const PetriEngine::MarkVal *marking,
+                   const uint32_t *first, const uint32_t *last)
+        {
+            assert(_last != nullptr && _hash == hash(spooler, guard_class, marking));
+            _last->spooler = spooler;
+            _last->guard_class = guard_class;
+            _last->hash = _hash;
+            _last->marking.assign(marking, marking + _nplaces);
+            _last->transitions.assign(first, last);
+            _last = nullptr;
+        }
+
+    private:
+        struct entry_t {
+            const SuccessorSpooler *spooler = nullptr;
+            size_t guard_class = SuccessorSpooler::NoGuardClass;
+            uint64_t hash = 0;
+            std::vector<PetriEngine::MarkVal> marking;
+            std::vector<uint32_t> transitions;
+        };
+
+        [[nodiscard]] uint64_t hash(const SuccessorSpooler *spooler, size_t guard_class,
+                                    const PetriEngine::MarkVal *marking) const
+        {
+            uint64_t h = UINT64_C(14695981039346656037) ^ reinterpret_cast<uintptr_t>(spooler) ^ guard_class;
+            for (size_t p = 0; p < _nplaces; ++p)
+                h = (h ^ marking[p]) * UINT64_C(1099511628211);
+            // the low bits pick the slot, so mix the high bits into them
+            return h ^ (h >> 29);
+        }
+
+        const size_t _nplaces;
+        std::vector<entry_t> _entries;
+        entry_t *_last = nullptr;
+        uint64_t _hash = 0;
+    };
+}
+
+#endif //VERIFYPN_STUBBORNSETCACHE_H
@@ -38,6 +38,7 @@ namespace LTL {
         {
             _markbuf.setMarking(net.makeInitialMarking());
             _retarding_stubborn_set.setInterestingVisitor<PetriEngine::AutomatonInterestingTransitionVisitor>();
+            _compute_guard_classes();
         }
 
         bool prepare(const PetriEngine::Structures::State *marking) override {
@@ -50,6 +51,12 @@ namespace LTL {
 
         void reset() override;
 
+        size_t guard_class(const LTL::Structures::ProductState &state) const override
+        {
+            return _guard_classes[state.getBuchiState()];
+        }
+
+        size_t enabled_transitions() const override { return nenabled(); }
 
     private:
         static bool has_shared_mark(const bool* a, const bool* b, size_t size) {
@@ -66,6 +73,8 @@ namespace LTL {
 
         PetriEngine::ReachabilityStubbornSet _retarding_stubborn_set;
         const std::vector<GuardInfo> _state_guards;
+        // Büchi states with the same guards and acceptance share a class
+        std::vector<size_t> _guard_classes;
         const Structures::BuchiAutomaton &_aut;
         std::unique_ptr<bool[]> _place_checkpoint;
         PetriEngine::SuccessorGenerator _gen;
@@ -91,6 +100,8 @@ namespace LTL {
 
         bool _cond3_valid(uint32_t t);
 
+        void _compute_guard_classes();
+
         friend class NondeterministicConjunctionVisitor;
     };
 
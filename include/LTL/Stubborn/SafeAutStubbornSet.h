@@ -51,14 +51,24 @@ namespace LTL {
             _has_enabled_stubborn = false;
         }
 
+        /**
+         * Set the conditions of the Büchi state of the next product state.
+         * @param guard_class shared by the Büchi states with the same conditions and acceptance.
+         */
         void set_buchi_conds(PetriEngine::PQL::Condition_ptr ret_cond,
                              PetriEngine::PQL::Condition_ptr prog_cond,
-                             PetriEngine::PQL::Condition_ptr sink_cond) {
+                             PetriEngine::PQL::Condition_ptr sink_cond,
+                             size_t guard_class) {
             _ret_cond = ret_cond;
             _prog_cond = prog_cond;
             _sink_cond = sink_cond;
+            _guard_class = guard_class;
         }
 
+        size_t guard_class(const LTL::Structures::ProductState &) const override { return _guard_class; }
+
+        size_t enabled_transitions() const override { return nenabled(); }
+
     protected:
         void addToStub(uint32_t t) override
         {
@@ -80,6 +90,7 @@ namespace LTL {
         PetriEngine::PQL::Condition_ptr _ret_cond;
         PetriEngine::PQL::Condition_ptr _prog_cond;
         PetriEngine::PQL::Condition_ptr _sink_cond;
+        size_t _guard_class = NoGuardClass;
 
         void _print_debug();
     };
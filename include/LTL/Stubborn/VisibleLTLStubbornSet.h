@@ -90,6 +90,11 @@ namespace LTL {
 
         bool generateAll(const LTL::Structures::ProductState *parent);
 
+        // visibility does not depend on the Büchi state
+        size_t guard_class(const LTL::Structures::ProductState &) const override { return 0; }
+
+        size_t enabled_transitions() const override { return nenabled(); }
+
     protected:
         void addToStub(uint32_t t) override;
 
@@ -95,12 +95,9 @@ namespace LTL {
         bool has_invariant_self_loop(size_t state) {
             if (self_loops[state] != InvariantSelfLoop::UNKNOWN)
                 return self_loops[state] == InvariantSelfLoop::TRUE;
-            auto it = std::unique_ptr<spot::twa_succ_iterator>{
-                    aut._buchi->succ_iter(aut._buchi->state_from_number(state))};
-            for (it->first(); !it->done(); it->next()) {
-                auto dest_id = aut._buchi->state_number(it->dst());
-                bdd cond = it->cond();
-                if (state == dest_id && cond == bddtrue) {
+            // compare node ids rather than copying the conditions, this runs during the (possibly concurrent) search
+            for (auto &e : aut._buchi->out(state)) {
+                if (e.dst == state && e.cond.id() == bddtrue.id()) {
                     self_loops[state] = InvariantSelfLoop::TRUE;
                     return true;
                 }
@@ -26,7 +26,7 @@
 #include "LTL/LTLToBuchi.h"
 #include "LTL/Stubborn/VisibleLTLStubbornSet.h"
 #include "LTL/Simplification/SpotToPQL.h"
-#include "LTL/Structures/GuardInfo.h"
+#include "LTL/Structures/GuardTable.h"
 #include "LTL/SuccessorGeneration/SpoolingSuccessorGenerator.h"
 #include "LTL/SuccessorGeneration/ResumingSuccessorGenerator.h"
 
@@ -43,7 +43,7 @@ namespace LTL {
                                   const Structures::BuchiAutomaton &buchi,
                                   SuccessorGen *successorGen)
                 : _successor_generator(successorGen), _net(net),
-                  buchi(buchi), aut(buchi)
+                  buchi(buchi), aut(buchi), _guards(buchi)
         {
 
         }
@@ -62,6 +62,7 @@ namespace LTL {
                     std::copy(_successor_generator->getParent(), _successor_generator->getParent() + state.buchi_state_idx + 1,
                               state.marking());
                 }
+                _guards.invalidate();
             }
             if (next_buchi_succ(state)) {
                 return true;
@@ -71,7 +72,8 @@ namespace LTL {
             else {
                 while (_successor_generator->next(state)) {
                     // reset buchi successors
-                    buchi.prepare(buchi_parent);
+                    prepare_buchi(buchi_parent);
+                    _guards.invalidate();
                     if (next_buchi_succ(state)) {
                         return true;
                     }
@@ -94,7 +96,8 @@ namespace LTL {
             LTL::Structures::ProductState state{&buchi.aut};
             state.setMarking(buf, _net->numberOfPlaces());
             //state.setBuchiState(initial_buchi_state());
-            buchi.prepare(state.getBuchiState());
+            prepare_buchi(state.getBuchiState());
+            _guards.invalidate();
             while (next_buchi_succ(state)) {
                 states.emplace_back(&buchi.aut);
                 states.back().setMarking(new PetriEngine::MarkVal[_net->numberOfPlaces() + 1], _net->numberOfPlaces());
@@ -118,16 +121,15 @@ namespace LTL {
         {
             _successor_generator->prepare(state, sucinfo);
             fresh_marking = sucinfo.fresh();
-            buchi.prepare(state->getBuchiState());
+            prepare_buchi(state->getBuchiState());
             buchi_parent = state->getBuchiState();
+            // the marking to evaluate guards in is only known at the next call to next.
+            _guards.invalidate();
             if (!fresh_marking) {
                 assert(sucinfo.buchi_state != std::numeric_limits<size_t>::max());
-                // spool Büchi successors until last state found.
-                // TODO is there perhaps a good way to avoid this, perhaps using raw edge vector?
-                // Caveat: it seems like there usually are not that many successors, so this is probably cheap regardless
-                size_t tmp;
-                while (buchi.next(tmp, cond)) {
-                    if (tmp == sucinfo.buchi_state) {
+                // skip Büchi successors until last state found.
+                while (_buchi_edge < _buchi_last) {
+                    if (_guards.edge(_buchi_edge++).dst == sucinfo.buchi_state) {
                         break;
                     }
                 }
@@ -151,6 +153,7 @@ namespace LTL {
                     std::copy(_successor_generator->getParent(), _successor_generator->getParent() + state.buchi_state_idx + 1,
                               state.marking());
                 }
+                _guards.invalidate();
             }
             if (next_buchi_succ(state)) {
                 //_successor_generator->getSuccInfo(sucinfo);
@@ -162,7 +165,8 @@ namespace LTL {
             else {
                 while (_successor_generator->next(state, sucinfo)) {
                     // reset buchi successors
-                    buchi.prepare(buchi_parent);
+                    prepare_buchi(buchi_parent);
+                    _guards.invalidate();
                     if (next_buchi_succ(state)) {
                         //_successor_generator->getSuccInfo(sucinfo);
                         sucinfo.buchi_state = state.getBuchiState();
@@ -217,6 +221,13 @@ namespace LTL {
 
         size_t buchiStates() { return buchi.buchiStates(); }
 
+        void printPORStats(std::ostream &os) const
+        {
+            if constexpr (std::is_same_v<SuccessorGen, LTL::SpoolingSuccessorGenerator>) {
+                _successor_generator->print_por_stats(os);
+            }
+        }
+
         void push() {
             if constexpr (std::is_same_v<SuccessorGen, LTL::SpoolingSuccessorGenerator>) {
                 _successor_generator->push();
@@ -241,28 +252,37 @@ namespace LTL {
         BuchiSuccessorGenerator buchi;
 
         const LTL::Structures::BuchiAutomaton &aut;
-        bdd cond;
+        Structures::GuardTable _guards;
+        // remaining Büchi edges of buchi_parent are [_buchi_edge, _buchi_last)
+        uint32_t _buchi_edge = 0;
+        uint32_t _buchi_last = 0;
         size_t buchi_parent;
         bool fresh_marking = true;
-        std::vector<GuardInfo> stateToGuards;
         /**
          * Evaluate binary decision diagram (BDD) representation of transition guard in given state.
          */
-        bool guard_valid(const PetriEngine::Structures::State &state, bdd bdd)
+        bool guard_valid(const PetriEngine::Structures::State &state, const bdd &cond)
         {
             PetriEngine::PQL::EvaluationContext ctx{state.marking(), _net};
-            return buchi.aut.guard_valid(ctx, bdd);
+            return buchi.aut.guard_valid(ctx, cond);
         }
 
 
     private:
 
+        void prepare_buchi(size_t state)
+        {
+            _buchi_edge = _guards.first_edge(state);
+            _buchi_last = _guards.last_edge(state);
+        }
+
         bool next_buchi_succ(LTL::Structures::ProductState &state)
         {
-            size_t tmp;
-            while (buchi.next(tmp, cond)) {
-                if (guard_valid(state, cond)) {
-                    state.setBuchiState(tmp);
+            PetriEngine::PQL::EvaluationContext ctx{state.marking(), _net};
+            while (_buchi_edge < _buchi_last) {
+                const auto &e = _guards.edge(_buchi_edge++);
+                if (_guards.valid(e.guard, ctx)) {
+                    state.setBuchiState(e.dst);
                     return true;
                 }
             }
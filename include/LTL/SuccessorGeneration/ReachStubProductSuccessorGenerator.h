@@ -21,6 +21,8 @@
 #include "LTL/SuccessorGeneration/ProductSuccessorGenerator.h"
 #include "LTL/SuccessorGeneration/Spoolers.h"
 
+#include <map>
+#include <tuple>
 
 namespace LTL {
     template<typename S, typename Spooler>
@@ -48,6 +50,14 @@ namespace LTL {
             std::vector<AtomicProposition> aps(buchi.ap_info.size());
             std::transform(std::begin(buchi.ap_info), std::end(buchi.ap_info), std::begin(aps),
                            [](const std::pair<int, AtomicProposition> &pair) { return pair.second; });
+            // Büchi states with the same conditions and acceptance get the same stubborn sets.
+            // The key holds the conditions themselves, as the id of a bdd that is no longer
+            // referenced can be reused by BuDDy for another condition.
+            auto by_id = [](const std::tuple<bool, bdd, bdd> &a, const std::tuple<bool, bdd, bdd> &b) {
+                return std::make_tuple(std::get<0>(a), std::get<1>(a).id(), std::get<2>(a).id()) <
+                       std::make_tuple(std::get<0>(b), std::get<1>(b).id(), std::get<2>(b).id());
+            };
+            std::map<std::tuple<bool, bdd, bdd>, size_t, decltype(by_id)> guard_classes(by_id);
             for (unsigned state = 0; state < buchi._buchi->num_states(); ++state) {
                 //if (buchi._buchi->state_is_accepting(state)) continue;
 
@@ -69,12 +79,16 @@ namespace LTL {
                                  : std::make_shared<PetriEngine::PQL::NotCondition>(
                                 std::make_shared<PetriEngine::PQL::OrCondition>(prog_cond, ret_cond)
                         );
+                auto guard_class = guard_classes.emplace(
+                        std::make_tuple(bool(buchi._buchi->state_is_accepting(state)), retarding, progressing),
+                        guard_classes.size()).first->second;
                 _reach_states.insert(std::make_pair(
                         state,
                         BuchiEdge{progressing | sink_prop,
                                   ret_cond,
                                   prog_cond,
-                                  sink_cond}));
+                                  sink_cond,
+                                  guard_class}));
             }
         }
 
@@ -86,7 +100,8 @@ namespace LTL {
             assert(suc != std::end(_reach_states));
             if (suc != std::end(_reach_states) && !this->guard_valid(*state, suc->second.bddCond)) {
                 //_reach->setQuery(suc->second.prog_cond.get());
-                _reach->set_buchi_conds(suc->second.ret_cond, suc->second.prog_cond, suc->second.pseudo_sink_cond);
+                _reach->set_buchi_conds(suc->second.ret_cond, suc->second.prog_cond, suc->second.pseudo_sink_cond,
+                                        suc->second.guard_class);
                 set_spooler(_reach.get());
             }
             else {
@@ -111,6 +126,7 @@ namespace LTL {
             PetriEngine::PQL::Condition_ptr ret_cond;
             PetriEngine::PQL::Condition_ptr prog_cond;
             PetriEngine::PQL::Condition_ptr pseudo_sink_cond;
+            size_t guard_class;
         };
 
         std::unique_ptr<Spooler> _fallback_spooler;
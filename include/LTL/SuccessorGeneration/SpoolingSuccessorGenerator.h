@@ -24,6 +24,10 @@
 #include "LTL/SuccessorGeneration/DistanceHeuristic.h"
 #include "LTL/SuccessorGeneration/SuccessorSpooler.h"
 #include "LTL/SuccessorGeneration/Heuristics.h"
+#include "LTL/Structures/StubbornSetCache.h"
+
+#include <memory>
+#include <ostream>
 
 namespace LTL {
     class SpoolingSuccessorGenerator : public PetriEngine::SuccessorGenerator {
@@ -61,6 +65,17 @@ namespace LTL {
             static constexpr auto NoLastState = std::numeric_limits<size_t>::max();
         };
 
+        // statistics of the spoolers which compute stubborn sets
+        struct por_stats_t {
+            // stubborn sets computed by a spooler and reused from the cache
+            size_t computed = 0, reused = 0;
+            // sums over the computed sets of the enabled and of the enabled stubborn transitions
+            size_t enabled = 0, stubborn = 0;
+            // computed sets which contain every enabled transition
+            size_t unreduced = 0;
+            size_t max_stubborn = 0;
+        };
+
         void setSpooler(SuccessorSpooler *const spooler)
         {
             _spooler = spooler;
@@ -93,25 +108,16 @@ namespace LTL {
 
             PetriEngine::SuccessorGenerator::prepare(state);
             if (sucinfo.successors == nullptr) {
-                uint32_t tid;
-                bool res = _spooler->prepare(state);
-                //assert(!res/* || !_net.deadlocked(state->marking())*/);
+                // generate list of transitions that generate a successor.
+                const uint32_t nsuc = spool(state);
                 if (!_heuristic || !_heuristic->has_heuristic(*state)) {
-                    uint32_t nsuc = 0;
-                    // generate list of transitions that generate a successor.
-                    while ((tid = _spooler->next()) != SuccessorSpooler::NoTransition) {
-                        assert(tid <= _net.numberOfTransitions());
-                        _transbuf[nsuc++] = tid;
-                        assert(nsuc <= _net.numberOfTransitions());
-                    }
                     sucinfo.successors = SuccessorQueue(_transbuf.get(), nsuc);
-                    assert((res && !sucinfo.successors.empty()) || !res);
                 } else {
                     // list of (transition, weight)
                     _heuristic->prepare(*state);
                     std::vector<std::pair<uint32_t, uint32_t>> weighted_tids;
-                    while ((tid = _spooler->next()) != SuccessorSpooler::NoTransition) {
-                        assert(tid <= _net.numberOfTransitions());
+                    for (uint32_t i = 0; i < nsuc; ++i) {
+                        const uint32_t tid = _transbuf[i];
                         SuccessorGenerator::_fire(_statebuf, tid);
                         _statebuf.setBuchiState(state->getBuchiState());
                         weighted_tids.emplace_back(tid, _heuristic->eval(_statebuf, tid));
@@ -205,6 +211,24 @@ namespace LTL {
             }
         }
 
+        [[nodiscard]] const por_stats_t &por_stats() const { return _por_stats; }
+
+        void print_por_stats(std::ostream &os) const
+        {
+            if (_por_stats.computed + _por_stats.reused == 0)
+                return;
+            const auto computed = std::max<size_t>(_por_stats.computed, 1);
+            os << "\tstubborn sets computed:   " << _por_stats.computed << std::endl
+               << "\tstubborn sets reused:     " << _por_stats.reused << std::endl
+               << "\tunreduced stubborn sets:  " << _por_stats.unreduced << std::endl
+               << "\tavg enabled transitions:  " << double(_por_stats.enabled) / computed << std::endl
+               << "\tavg stubborn transitions: " << double(_por_stats.stubborn) / computed << std::endl
+               << "\tmax stubborn transitions: " << _por_stats.max_stubborn << std::endl
+               << "\treduction ratio:          "
+               << (_por_stats.enabled == 0 ? 0.0 : 1.0 - double(_por_stats.stubborn) / _por_stats.enabled)
+               << std::endl;
+        }
+
         void push() {
             // No transitions have been fired yet. We must be in the initial marking.
             if (!_heuristic || fired() == std::numeric_limits<uint32_t>::max()) return;
@@ -217,8 +241,53 @@ namespace LTL {
         }
 
     private:
+        /**
+         * Write the transitions the spooler gives for state to _transbuf, reusing the stubborn
+         * set of an earlier state with the same marking and guard class if it is cached.
+         * @return the number of transitions.
+         */
+        uint32_t spool(const Structures::ProductState *state)
+        {
+            const size_t guard_class = _spooler->guard_class(*state);
+            if (guard_class != SuccessorSpooler::NoGuardClass) {
+                if (!_cache)
+                    _cache = std::make_unique<Structures::StubbornSetCache>(_net);
+                if (auto cached = _cache->find(_spooler, guard_class, state->marking())) {
+                    ++_por_stats.reused;
+                    std::copy(cached->begin(), cached->end(), _transbuf.get());
+                    return cached->size();
+                }
+            }
+
+            uint32_t tid;
+            uint32_t nsuc = 0;
+            bool res = _spooler->prepare(state);
+            //assert(!res/* || !_net.deadlocked(state->marking())*/);
+            const size_t nenabled = _spooler->enabled_transitions();
+            while ((tid = _spooler->next()) != SuccessorSpooler::NoTransition) {
+                assert(tid <= _net.numberOfTransitions());
+                _transbuf[nsuc++] = tid;
+                assert(nsuc <= _net.numberOfTransitions());
+            }
+            assert((res && nsuc > 0) || !res);
+
+            if (guard_class != SuccessorSpooler::NoGuardClass) {
+                _cache->store(_spooler, guard_class, state->marking(), _transbuf.get(), _transbuf.get() + nsuc);
+                ++_por_stats.computed;
+                if (nenabled != SuccessorSpooler::UnknownEnabled) {
+                    _por_stats.enabled += nenabled;
+                    if (nsuc == nenabled) ++_por_stats.unreduced;
+                }
+                _por_stats.stubborn += nsuc;
+                _por_stats.max_stubborn = std::max<size_t>(_por_stats.max_stubborn, nsuc);
+            }
+            return nsuc;
+        }
+
         SuccessorSpooler *_spooler = nullptr;
         Heuristic *_heuristic = nullptr;
+        std::unique_ptr<Structures::StubbornSetCache> _cache;
+        por_stats_t _por_stats;
 
         uint32_t _last = std::numeric_limits<uint32_t>::max();
         std::unique_ptr<uint32_t[]> _transbuf;   /* buffer for enabled transitions, size is ntransitions. */
@@ -38,7 +38,29 @@ namespace LTL {
         {
             return false;
         }
+
+        /**
+         * Class of the Büchi state of state with respect to this spooler. Product states with
+         * the same marking and guard class get the same transitions from the spooler, so these
+         * can be reused. NoGuardClass if the transitions should not be reused.
+         */
+        virtual size_t guard_class(const LTL::Structures::ProductState &state) const
+        {
+            return NoGuardClass;
+        }
+
+        /**
+         * Number of enabled transitions in the state given to the last prepare, or UnknownEnabled.
+         * Only valid before the transitions are spooled.
+         */
+        virtual size_t enabled_transitions() const
+        {
+            return UnknownEnabled;
+        }
+
         static constexpr uint32_t NoTransition = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t NoGuardClass = std::numeric_limits<size_t>::max();
+        static constexpr size_t UnknownEnabled = std::numeric_limits<size_t>::max();
     };
 }
 
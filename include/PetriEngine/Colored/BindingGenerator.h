@@ -22,6 +22,7 @@
 
 #include "ColoredNetStructures.h"
 #include "EquivalenceClass.h"
+#include "CompiledExpression.h"
 
 namespace PetriEngine {
 
@@ -43,12 +44,13 @@ namespace PetriEngine {
         Colored::GuardExpression_ptr _expr;
         Colored::BindingMap _bindings;
         Colored::ColorTypeMap& _colorTypes;
+        Colored::CompiledTransition& _compiled;
         
         bool eval() const;
         
     public:
         NaiveBindingGenerator(const Colored::Transition& transition,
-                Colored::ColorTypeMap& colorTypes);
+                Colored::ColorTypeMap& colorTypes, Colored::CompiledTransition& compiled);
 
         const Colored::BindingMap& nextBinding();
         const Colored::BindingMap& currentBinding() const;
@@ -79,6 +81,7 @@ namespace PetriEngine {
         std::vector<std::vector<std::vector<uint32_t>>> _symmetric_var_combinations;
         const Colored::ColorTypeMap& _colorTypes;
         const Colored::Transition &_transition;
+        Colored::CompiledTransition& _compiled;
         const std::vector<std::set<const Colored::Variable *>>& _symmetric_vars;
         Colored::BindingMap::iterator _bindingIterator;
         bool _isDone;
@@ -98,7 +101,8 @@ namespace PetriEngine {
         
     public:
         FixpointBindingGenerator(const Colored::Transition &transition,
-                const Colored::ColorTypeMap& colorTypes,  const std::vector<std::set<const Colored::Variable *>>& symmetric_vars);
+                const Colored::ColorTypeMap& colorTypes,  const std::vector<std::set<const Colored::Variable *>>& symmetric_vars,
+                Colored::CompiledTransition& compiled);
 
         FixpointBindingGenerator(const FixpointBindingGenerator& ) = default;
         
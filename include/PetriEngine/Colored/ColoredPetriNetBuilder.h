@@ -131,11 +131,30 @@ namespace PetriEngine {
             return _ptplacenames;
         }
 
-        const PTTransitionMap& getUnfoldedTransitionNames() const {
-            return _pttransitionnames;
+        /** Makes the names from the counts on the first call, so it is best only called when a name is needed */
+        const PTTransitionMap& getUnfoldedTransitionNames();
+
+        const std::vector<Colored::Place>& getPlaces() const {
+            return _places;
         }
-        
-        PetriNetBuilder& unfold();
+
+        const std::vector<Colored::Transition>& getTransitions() const {
+            return _transitions;
+        }
+
+        const std::vector<Colored::Arc>& getInhibitorArcs() const {
+            return _inhibitorArcs;
+        }
+
+        const Colored::ColorTypeMap& getColorTypes() const {
+            return _colors;
+        }
+
+        /**
+         * Unfold the net. With more than one thread the bindings of the colored transitions are
+         * computed in parallel, the unfolded net is the same as with a single thread.
+         */
+        PetriNetBuilder& unfold(uint32_t threads = 1);
         PetriNetBuilder& stripColors();
         void computePlaceColorFixpoint(uint32_t max_intervals, uint32_t max_intervals_reduced, int32_t timeout);
         void computePartition(int32_t timeout);
@@ -151,6 +170,10 @@ namespace PetriEngine {
         std::unordered_map<uint32_t,FixpointBindingGenerator> _bindings;
         PTPlaceMap _ptplacenames;
         PTTransitionMap _pttransitionnames;
+        //Number of unfolded transitions of each colored transition, _pttransitionnames is made from them when it is needed
+        std::vector<uint32_t> _ptTransitionCounts;
+        //Ids in _ptBuilder of the unfolded places of each colored place, by the id of UnfoldedArc
+        std::vector<std::unordered_map<uint32_t, uint32_t>> _ptPlaceIds;
         uint32_t _nptarcs = 0;
         uint32_t _maxIntervals = 0;
         const Colored::IntervalGenerator intervalGenerator = Colored::IntervalGenerator();
@@ -162,7 +185,7 @@ namespace PetriEngine {
         //transition id to vector of vectors of variables, where variable in vector are symmetric
         std::unordered_map<uint32_t, std::vector<std::set<const Colored::Variable *>>> symmetric_var_map;
 
-        std::unordered_map<uint32_t, std::string> _sumPlacesNames;
+        std::vector<uint32_t> _sumPlaceIds;
         Colored::ColorTypeMap _colors;
         PetriNetBuilder _ptBuilder;
         bool _unfolded = false;
@@ -200,13 +223,36 @@ namespace PetriEngine {
         void processInputArcs(Colored::Transition& transition, uint32_t currentPlaceId, uint32_t transitionId, bool &transitionActivated, uint32_t max_intervals);
         void processOutputArcs(Colored::Transition& transition);
         
-        void unfoldPlace(const Colored::Place* place, const PetriEngine::Colored::Color *color, uint32_t unfoldPlace, uint32_t id);
+        //Arc of an unfolded transition, to the place unfolded for color/id of place,
+        //or to the sum place of place if color is nullptr
+        struct UnfoldedArc {
+            const Colored::Color* color;
+            uint32_t place;
+            uint32_t id;
+            uint32_t weight;
+            bool input;
+        };
+
+        //The arcs of every binding of a colored transition, the arcs of binding i end at bindingEnd[i]
+        struct UnfoldedTransition {
+            std::vector<UnfoldedArc> arcs;
+            std::vector<size_t> bindingEnd;
+        };
+
+        uint32_t unfoldPlace(const Colored::Place* place, const PetriEngine::Colored::Color *color, uint32_t unfoldPlace, uint32_t id);
+        uint32_t unfoldSumPlace(uint32_t placeId);
         void unfoldTransition(uint32_t transitionId);
+        void unfoldTransitions(uint32_t threads);
+        void prepareUnfolding();
+        //Only reads the colored net, so it can be run on several transitions in parallel
+        void computeBindings(uint32_t transitionId, UnfoldedTransition& unfolded);
+        void addUnfoldedTransition(uint32_t transitionId, const UnfoldedTransition& unfolded);
         void handleOrphanPlace(const Colored::Place& place, const std::unordered_map<std::string, uint32_t> &unfoldedPlaceMap);
         void createPartionVarmaps();
-        void unfoldInhibitorArc(const std::string &oldname, const std::string &newname);
+        void unfoldInhibitorArc(uint32_t transitionId, uint32_t ptTransitionId);
 
-        void unfoldArc(const Colored::Arc& arc, const Colored::BindingMap& binding, const std::string& name);
+        void unfoldArc(const Colored::Arc& arc, Colored::CompiledTransition& compiled, uint32_t arcIndex, std::vector<UnfoldedArc>& arcs) const;
+        void addUnfoldedArc(const UnfoldedArc& arc, uint32_t ptTransitionId);
     };
     
     //Used for checking if a variable is inside either a succ or pred expression
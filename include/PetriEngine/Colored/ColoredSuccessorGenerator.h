@@ -0,0 +1,101 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLOREDSUCCESSORGENERATOR_H
+#define COLOREDSUCCESSORGENERATOR_H
+
+#include <vector>
+
+#include "ColoredPetriNetBuilder.h"
+#include "CompiledExpression.h"
+#include "../PetriNet.h"
+#include "../Structures/ColoredStateSet.h"
+
+namespace PetriEngine {
+    namespace Colored {
+
+        /**
+         * Fires the transitions of a colored net on colored markings without unfolding it.
+         * The bindings of a transition are enumerated on the fly. A variable of a token an input arc always
+         * takes is only bound to the colors of the tokens in that place, the other variables range over
+         * their whole domain, so transitions with several such variables of large types are slow to fire.
+         * The net given is the one made by ColoredPetriNetBuilder::stripColors, whose places hold
+         * the number of tokens of the colored places and whose transitions are reported by fired().
+         */
+        class ColoredSuccessorGenerator {
+        public:
+            ColoredSuccessorGenerator(const PetriNet& net, const ColoredPetriNetBuilder& builder);
+
+            /** Set the colored places of state to the initial marking, the counts must already be set */
+            void initialize(Structures::ColoredState& state) const;
+
+            bool prepare(const Structures::State* state);
+            bool next(Structures::State& write);
+
+            uint32_t fired() const {
+                return _netTransitions[_transition];
+            }
+
+            // the enabled bindings are always computed from scratch
+            void setIncremental(bool) {}
+
+        private:
+            //The input arcs of a transition from one place
+            struct InputPlace {
+                uint32_t place;
+                std::vector<uint32_t> arcs;
+                //Tokens every binding takes at least, the arcs whose weight depends on the binding count as 0
+                uint32_t weight;
+            };
+
+            //An input place and the position in the tuple of its tokens a variable is taken from, -1 for the whole token
+            typedef std::pair<uint32_t, int32_t> TokenPosition;
+
+            struct TransitionInfo {
+                std::vector<InputPlace> inputs;
+                //For every variable the tokens it is taken from, empty if it ranges over its domain
+                std::vector<std::vector<TokenPosition>> tokens;
+                //Place and weight of the inhibitor arcs
+                std::vector<std::pair<uint32_t, uint32_t>> inhibitors;
+            };
+
+            bool firstBinding();
+            bool nextBinding();
+            bool tokenColors(const std::vector<InputPlace>& inputs, const std::vector<TokenPosition>& tokens, std::vector<const Color*>& colors) const;
+            void bind();
+            bool enabled();
+            void fire(Structures::ColoredState& write);
+
+            const ColoredPetriNetBuilder& _builder;
+            std::vector<CompiledTransition> _compiled;
+            std::vector<TransitionInfo> _info;
+            std::vector<uint32_t> _netTransitions;
+            std::vector<uint32_t> _netPlaces;
+            const Structures::ColoredState* _parent = nullptr;
+            uint32_t _transition = 0;
+            bool _binding = false;
+            //Index of the color of every variable of the current transition, in its candidates or its domain
+            std::vector<uint32_t> _colors;
+            //The colors of the tokens a variable can be taken from
+            std::vector<std::vector<const Color*>> _candidates;
+            //The tokens of each input place taken by the current binding
+            std::vector<Multiset> _consumed;
+            const EquivalenceVec _noPartition;
+        };
+    }
+}
+
+#endif /* COLOREDSUCCESSORGENERATOR_H */
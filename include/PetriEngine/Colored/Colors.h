@@ -29,6 +29,8 @@
 #include <unordered_map>
 #include <iostream>
 #include <cassert>
+#include <mutex>
+#include <shared_mutex>
 
 #include "Intervals.h"
 
@@ -187,7 +189,9 @@ namespace PetriEngine {
         class ProductType : public ColorType {
         private:
             std::vector<const ColorType*> _constituents;
+            // colors are made on first use, possibly by several threads unfolding the net
             mutable std::unordered_map<size_t,Color> _cache;
+            mutable std::shared_mutex _cacheLock;
 
         public:
             ProductType(const std::string& name = "Undefined") : ColorType(name) {}
@@ -0,0 +1,224 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLORED_COMPILEDEXPRESSION_H
+#define COLORED_COMPILEDEXPRESSION_H
+
+#include <vector>
+
+#include "Colors.h"
+#include "Multiset.h"
+#include "EquivalenceVec.h"
+
+namespace PetriEngine {
+    namespace Colored {
+        class GuardExpression;
+        class ArcExpression;
+        struct Transition;
+
+        enum class ExpressionOp : uint8_t {
+            //Push a color on the color stack
+            Color,
+            Variable,
+            UserOperator,
+            //Replace the top of the color stack
+            Successor,
+            Predecessor,
+            //Pop arg colors and push their tuple of type productType
+            Tuple,
+            //Pop two colors and set the guard result
+            LessThan,
+            GreaterThan,
+            LessThanEq,
+            GreaterThanEq,
+            Equal,
+            NotEqual,
+            //Continue at instruction arg depending on the guard result
+            JumpIfFalse,
+            JumpIfTrue,
+            //Add arg times the popped color or all colors of colorType to the top multiset
+            AddColor,
+            AddAll,
+            //Multiset stack operations, the result of an arc expression is the bottom multiset
+            PushMultiset,
+            Scale,
+            Subtract,
+            Merge
+        };
+
+        struct ExpressionInstruction {
+            ExpressionOp op;
+            //variable slot, tuple size, jump target, multiplicity or scalar
+            uint32_t arg;
+            union {
+                const Color* color;
+                const ColorType* colorType;
+                const ProductType* productType;
+            };
+        };
+
+        /**
+         * A guard or arc expression lowered to a flat list of instructions.
+         * Variables are read from the slots of an ExpressionEvaluator, see ExpressionCompiler::variables.
+         */
+        class CompiledExpression {
+        public:
+            bool empty() const {
+                return _code.empty();
+            }
+
+            /**
+             * The variables an arc expression takes a token of for every binding, as the variable slot
+             * and the position of the variable in the tuple of the token, or -1 if the token is the variable.
+             * Only tokens added directly to the result are found, not those of scalar products or subtractions.
+             */
+            std::vector<std::pair<uint32_t, int32_t>> tokenVariables() const;
+
+        private:
+            friend class ExpressionCompiler;
+            friend class ExpressionEvaluator;
+
+            std::vector<ExpressionInstruction> _code;
+            uint32_t _colorDepth = 0;
+            uint32_t _multisetDepth = 1;
+        };
+
+        /**
+         * Lowers expressions through their compile methods.
+         * All expressions compiled by the same compiler share the variable slots.
+         */
+        class ExpressionCompiler {
+        public:
+            explicit ExpressionCompiler(const ColorTypeMap& colorTypes)
+                    : _colorTypes(colorTypes) {}
+
+            CompiledExpression compile(const GuardExpression& expr);
+            CompiledExpression compile(const ArcExpression& expr);
+
+            const std::vector<const Variable*>& variables() const {
+                return _variables;
+            }
+
+            void pushColor(const Color* color);
+            void pushVariable(const Variable* variable);
+            void pushUserOperator(const Color* color);
+            void successor();
+            void predecessor();
+            void tuple(uint32_t size);
+            void compare(ExpressionOp op);
+            size_t jump(ExpressionOp op);
+            //Make the jump at the given position go to the next instruction
+            void patch(size_t jump);
+            void addColor(uint32_t multiplicity);
+            void addAll(const ColorType* sort, uint32_t multiplicity);
+            void pushMultiset();
+            void scale(uint32_t scalar);
+            void subtract();
+            void merge();
+
+        private:
+            ExpressionInstruction& emit(ExpressionOp op, uint32_t arg = 0);
+            void pushType(const ColorType* type);
+            uint32_t slot(const Variable* variable);
+
+            const ColorTypeMap& _colorTypes;
+            std::vector<const Variable*> _variables;
+            //Types of the colors on the color stack when the compiled code runs
+            std::vector<const ColorType*> _types;
+            uint32_t _multisets = 0;
+            CompiledExpression* _current = nullptr;
+        };
+
+        /**
+         * Runs compiled expressions. The buffers are kept between evaluations,
+         * so once they have grown no evaluation allocates.
+         */
+        class ExpressionEvaluator {
+        public:
+            ExpressionEvaluator() = default;
+            explicit ExpressionEvaluator(const std::vector<const Variable*>& variables)
+                    : _variables(variables), _slots(variables.size(), nullptr) {}
+
+            void bind(const BindingMap& binding);
+
+            void bind(uint32_t slot, const Color* color) {
+                _slots[slot] = color;
+            }
+
+            const std::vector<const Variable*>& variables() const {
+                return _variables;
+            }
+
+            bool evalGuard(const CompiledExpression& expr);
+            /** The result is valid until the next evaluation */
+            const Multiset& evalArc(const CompiledExpression& expr, const EquivalenceVec& placePartition);
+
+        private:
+            bool run(const CompiledExpression& expr, const EquivalenceVec& placePartition);
+
+            std::vector<const Variable*> _variables;
+            std::vector<const Color*> _slots;
+            std::vector<const Color*> _colors;
+            std::vector<const Color*> _tuple;
+            std::vector<uint32_t> _tupleIds;
+            std::vector<Multiset> _multisets;
+            size_t _top = 0;
+        };
+
+        /** The guard and the arc expressions of a transition compiled over one set of variable slots */
+        class CompiledTransition {
+        public:
+            CompiledTransition(const Transition& transition, const ColorTypeMap& colorTypes);
+
+            void bind(const BindingMap& binding) {
+                _evaluator.bind(binding);
+            }
+
+            void bind(uint32_t slot, const Color* color) {
+                _evaluator.bind(slot, color);
+            }
+
+            /** The variables of the transition, a variable is bound by its index */
+            const std::vector<const Variable*>& variables() const {
+                return _evaluator.variables();
+            }
+
+            bool evalGuard() {
+                return _guard.empty() || _evaluator.evalGuard(_guard);
+            }
+
+            const CompiledExpression& inputArc(size_t arc) const {
+                return _inputArcs[arc];
+            }
+
+            const Multiset& evalInputArc(size_t arc, const EquivalenceVec& placePartition) {
+                return _evaluator.evalArc(_inputArcs[arc], placePartition);
+            }
+
+            const Multiset& evalOutputArc(size_t arc, const EquivalenceVec& placePartition) {
+                return _evaluator.evalArc(_outputArcs[arc], placePartition);
+            }
+
+        private:
+            CompiledExpression _guard;
+            std::vector<CompiledExpression> _inputArcs;
+            std::vector<CompiledExpression> _outputArcs;
+            ExpressionEvaluator _evaluator;
+        };
+    }
+}
+
+#endif /* COLORED_COMPILEDEXPRESSION_H */
@@ -35,6 +35,7 @@
 #include "EquivalenceVec.h"
 #include "ArcIntervals.h"
 #include "GuardRestrictor.h"
+#include "CompiledExpression.h"
 #include "../errorcodes.h"
 
 namespace PetriEngine {
@@ -135,6 +136,8 @@ namespace PetriEngine {
             
             virtual const Color* eval(const ExpressionContext& context) const = 0;
 
+            virtual void compile(ExpressionCompiler& compiler) const = 0;
+
             virtual void getConstants(std::unordered_map<uint32_t, const Color*> &constantMap, uint32_t &index) const = 0;
 
             virtual bool getArcIntervals(Colored::ArcIntervals& arcIntervals, const PetriEngine::Colored::ColorFixpoint& cfp, uint32_t& index, int32_t modifier) const = 0;
@@ -153,6 +156,10 @@ namespace PetriEngine {
                 return &(*ColorType::dotInstance()->begin());
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                compiler.pushColor(&(*ColorType::dotInstance()->begin()));
+            }
+
             bool getArcIntervals(Colored::ArcIntervals& arcIntervals,const PetriEngine::Colored::ColorFixpoint& cfp, uint32_t& index, int32_t modifier) const override {
                 if (arcIntervals._intervalTupleVec.empty()) {
                     //We can add all place tokens when considering the dot constant as, that must be present
@@ -197,6 +204,10 @@ namespace PetriEngine {
             const Color* eval(const ExpressionContext& context) const override {
                 return context.binding.find(_variable)->second;
             }
+
+            void compile(ExpressionCompiler& compiler) const override {
+                compiler.pushVariable(_variable);
+            }
             
             void getVariables(std::set<const Colored::Variable*>& variables, PositionVariableMap& varPositions, VariableModifierMap& varModifierMap, bool includeSubtracts, uint32_t& index) const override {
                 variables.insert(_variable);
@@ -283,6 +294,10 @@ namespace PetriEngine {
                 
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                compiler.pushUserOperator(_userOperator);
+            }
+
             bool getArcIntervals(Colored::ArcIntervals& arcIntervals,const PetriEngine::Colored::ColorFixpoint& cfp, uint32_t& index, int32_t modifier) const override {
                 uint32_t colorId = _userOperator->getId() + modifier;
                 while(colorId < 0){
@@ -354,6 +369,11 @@ namespace PetriEngine {
                 return &++(*_color->eval(context));
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _color->compile(compiler);
+                compiler.successor();
+            }
+
             bool isTuple() const override {
                 return _color->isTuple();
             }
@@ -412,6 +432,11 @@ namespace PetriEngine {
                 return &--(*_color->eval(context));
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _color->compile(compiler);
+                compiler.predecessor();
+            }
+
             bool isTuple() const override {
                 return _color->isTuple();
             }
@@ -481,6 +506,13 @@ namespace PetriEngine {
                 return col;
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                for (const auto& color : _colors) {
+                    color->compile(compiler);
+                }
+                compiler.tuple(_colors.size());
+            }
+
             bool isTuple() const override {
                 return true;
             }
@@ -584,6 +616,8 @@ namespace PetriEngine {
             
             virtual bool eval(const ExpressionContext& context) const = 0;
 
+            virtual void compile(ExpressionCompiler& compiler) const = 0;
+
             virtual void restrictVars(std::vector<VariableIntervalMap>& variableMap, std::set<const Colored::Variable*> &diagonalVars) const = 0;
 
             virtual void restrictVars(std::vector<VariableIntervalMap>& variableMap) const {
@@ -604,6 +638,12 @@ namespace PetriEngine {
                 return _left->eval(context) < _right->eval(context);
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _left->compile(compiler);
+                _right->compile(compiler);
+                compiler.compare(ExpressionOp::LessThan);
+            }
+
             void getVariables(std::set<const Colored::Variable*>& variables, PositionVariableMap& varPositions, VariableModifierMap& varModifierMap, bool includeSubtracts, uint32_t& index) const override {
                 _left->getVariables(variables, varPositions, varModifierMap, includeSubtracts);
                 _right->getVariables(variables, varPositions, varModifierMap, includeSubtracts);
@@ -656,6 +696,12 @@ namespace PetriEngine {
                 return _left->eval(context) > _right->eval(context);
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _left->compile(compiler);
+                _right->compile(compiler);
+                compiler.compare(ExpressionOp::GreaterThan);
+            }
+
             bool isTuple() const override {
                 return _left->isTuple() || _right->isTuple();
             }
@@ -708,6 +754,12 @@ namespace PetriEngine {
                 return _left->eval(context) <= _right->eval(context);
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _left->compile(compiler);
+                _right->compile(compiler);
+                compiler.compare(ExpressionOp::LessThanEq);
+            }
+
             bool isTuple() const override {
                 return _left->isTuple() || _right->isTuple();
             }
@@ -761,6 +813,12 @@ namespace PetriEngine {
                 return _left->eval(context) >= _right->eval(context);
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _left->compile(compiler);
+                _right->compile(compiler);
+                compiler.compare(ExpressionOp::GreaterThanEq);
+            }
+
             bool isTuple() const override {
                 return _left->isTuple() || _right->isTuple();
             }
@@ -812,6 +870,12 @@ namespace PetriEngine {
             bool eval(const ExpressionContext& context) const override {
                 return _left->eval(context) == _right->eval(context);
             }
+
+            void compile(ExpressionCompiler& compiler) const override {
+                _left->compile(compiler);
+                _right->compile(compiler);
+                compiler.compare(ExpressionOp::Equal);
+            }
             
             bool isTuple() const override {
                 return _left->isTuple() || _right->isTuple();
@@ -866,6 +930,12 @@ namespace PetriEngine {
                 return _left->eval(context) != _right->eval(context);
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _left->compile(compiler);
+                _right->compile(compiler);
+                compiler.compare(ExpressionOp::NotEqual);
+            }
+
             bool isTuple() const override {
                 return _left->isTuple() || _right->isTuple();
             }
@@ -917,6 +987,13 @@ namespace PetriEngine {
                 return _left->eval(context) && _right->eval(context);
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _left->compile(compiler);
+                size_t jump = compiler.jump(ExpressionOp::JumpIfFalse);
+                _right->compile(compiler);
+                compiler.patch(jump);
+            }
+
             bool isTuple() const override {
                 return _left->isTuple() || _right->isTuple();
             }
@@ -950,6 +1027,13 @@ namespace PetriEngine {
                 return _left->eval(context) || _right->eval(context);
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                _left->compile(compiler);
+                size_t jump = compiler.jump(ExpressionOp::JumpIfTrue);
+                _right->compile(compiler);
+                compiler.patch(jump);
+            }
+
             bool isTuple() const override {
                 return _left->isTuple() || _right->isTuple();
             }
@@ -983,6 +1067,8 @@ namespace PetriEngine {
             
             virtual Multiset eval(const ExpressionContext& context) const = 0;
 
+            virtual void compile(ExpressionCompiler& compiler) const = 0;
+
             virtual void getConstants(PositionColorsMap &constantMap, uint32_t &index) const = 0;
 
             virtual bool getArcIntervals(Colored::ArcIntervals& arcIntervals,const PetriEngine::Colored::ColorFixpoint& cfp, uint32_t& index, int32_t modifier) const = 0;
@@ -1024,6 +1110,10 @@ namespace PetriEngine {
                 return colors;
             }
 
+            void compile(ExpressionCompiler& compiler, uint32_t multiplicity) const {
+                compiler.addAll(_sort, multiplicity);
+            }
+
             bool isTuple() const override {
                 return _sort->productSize() > 1;
             }
@@ -1104,6 +1194,17 @@ namespace PetriEngine {
                 
                 return Multiset(col);
             }
+
+            void compile(ExpressionCompiler& compiler) const override {
+                if (!_color.empty()) {
+                    for (const auto& elem : _color) {
+                        elem->compile(compiler);
+                        compiler.addColor(_number);
+                    }
+                } else if (_all != nullptr) {
+                    _all->compile(compiler, _number);
+                }
+            }
             bool isEligibleForSymmetry(std::vector<uint32_t>& numbers) const override{
                 //Not entirely sure what to do if there is more than one colorExpression, but should probably return false
                 if(_color.size() > 1){
@@ -1221,6 +1322,12 @@ namespace PetriEngine {
                 return ms;
             }
 
+            void compile(ExpressionCompiler& compiler) const override {
+                for (const auto& expr : _constituents) {
+                    expr->compile(compiler);
+                }
+            }
+
             bool isEligibleForSymmetry(std::vector<uint32_t>& numbers) const override{
                 for(const auto& elem : _constituents){
                     if(!elem->isEligibleForSymmetry(numbers)){
@@ -1328,6 +1435,15 @@ namespace PetriEngine {
             Multiset eval(const ExpressionContext& context) const override {
                 return _left->eval(context) - _right->eval(context);
             }
+
+            void compile(ExpressionCompiler& compiler) const override {
+                compiler.pushMultiset();
+                _left->compile(compiler);
+                compiler.pushMultiset();
+                _right->compile(compiler);
+                compiler.subtract();
+                compiler.merge();
+            }
             
             void getVariables(std::set<const Colored::Variable*>& variables, PositionVariableMap& varPositions, VariableModifierMap& varModifierMap, bool includeSubtracts, uint32_t& index) const override {
                 _left->getVariables(variables, varPositions, varModifierMap, includeSubtracts);
@@ -1389,6 +1505,13 @@ namespace PetriEngine {
             Multiset eval(const ExpressionContext& context) const override {
                 return _expr->eval(context) * _scalar;
             }
+
+            void compile(ExpressionCompiler& compiler) const override {
+                compiler.pushMultiset();
+                _expr->compile(compiler);
+                compiler.scale(_scalar);
+                compiler.merge();
+            }
             
             void getVariables(std::set<const Colored::Variable*>& variables, PositionVariableMap& varPositions, VariableModifierMap& varModifierMap, bool includeSubtracts, uint32_t& index) const override {
                 _expr->getVariables(variables, varPositions,varModifierMap, includeSubtracts);
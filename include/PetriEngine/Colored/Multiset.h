@@ -22,6 +22,12 @@
 
 namespace PetriEngine {
     namespace Colored {
+        /*
+         * Colors are kept as (id, count) entries sorted by the color id. Up to
+         * InlineSize entries are stored in the multiset itself and the rest in a
+         * heap block, which clear() and the in-place operators keep, so multisets
+         * that are reused stop allocating once they have grown.
+         */
         class Multiset {
         private:
             class Iterator {
@@ -40,14 +46,23 @@ namespace PetriEngine {
                 std::pair<const Color*, const uint32_t&> operator*();
             };
 
-            typedef std::vector<std::pair<uint32_t,uint32_t>> Internal;
+            struct Entry {
+                uint32_t id;
+                uint32_t count;
+            };
+
+            static constexpr uint32_t InlineSize = 4;
             
         public:
             Multiset();
             Multiset(const Multiset& orig);
+            Multiset(Multiset&& orig) noexcept;
             Multiset(std::pair<const Color*,uint32_t> color);
             Multiset(std::vector<std::pair<const Color*,uint32_t>>& colors);
             virtual ~Multiset();
+
+            Multiset& operator= (const Multiset& other);
+            Multiset& operator= (Multiset&& other) noexcept;
             
             Multiset operator+ (const Multiset& other) const;
             Multiset operator- (const Multiset& other) const;
@@ -57,12 +72,17 @@ namespace PetriEngine {
             void operator*= (uint32_t scalar);
             uint32_t operator[] (const Color* color) const;
             uint32_t& operator[] (const Color* color);
+
+            //Every color has at least as many tokens in other
+            bool isSubsetOf(const Multiset& other) const;
             
             bool empty() const;
             void clean();
+            //Remove all colors and the type, keeping the storage
+            void clear();
 
             size_t distinctSize() const {
-                return _set.size();
+                return _size;
             }
 
             size_t size() const;
@@ -73,11 +93,37 @@ namespace PetriEngine {
             std::string toString() const;
             
         private:
-            Internal _set;
+            bool onHeap() const {
+                return _capacity != 0;
+            }
+
+            uint32_t capacity() const {
+                return onHeap() ? _capacity : InlineSize;
+            }
+
+            Entry* data() {
+                return onHeap() ? _heap : _inline;
+            }
+
+            const Entry* data() const {
+                return onHeap() ? _heap : _inline;
+            }
+
+            const Entry* find(uint32_t id) const;
+            const Color* color(uint32_t id) const;
+            void reserve(uint32_t size);
+            void release();
+
+            // _capacity is zero while the entries are inline
+            union {
+                Entry* _heap;
+                Entry _inline[InlineSize];
+            };
+            uint32_t _size = 0;
+            uint32_t _capacity = 0;
             const ColorType* _type;
         };
     }
 }
 
 #endif /* MULTISET_H */
-
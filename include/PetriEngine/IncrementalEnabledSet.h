@@ -0,0 +1,132 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef INCREMENTALENABLEDSET_H
+#define INCREMENTALENABLEDSET_H
+
+#include "PetriNet.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace PetriEngine {
+
+    /**
+     * The enabled transitions of the most recently updated marking. The next
+     * marking is compared to it, and only the transitions with an (inhibitor)
+     * input arc from a place whose token count changed are re-checked. This
+     * is cheap when consecutive markings are a parent and its successor, as in
+     * DFS. The set is recomputed from scratch when too many places changed.
+     */
+    class IncrementalEnabledSet {
+    public:
+        IncrementalEnabledSet(const PetriNet& net)
+        : _net(net), _marking(net._nplaces), _enabled(net._ntransitions), _offsets(net._nplaces + 1, 0)
+        {
+            for(uint32_t t = 0; t < net._ntransitions; ++t)
+                for(auto i = net._transitions[t].inputs; i < net._transitions[t].outputs; ++i)
+                    ++_offsets[net._invariants[i].place + 1];
+            for(uint32_t p = 0; p < net._nplaces; ++p)
+                _offsets[p + 1] += _offsets[p];
+            _consumers.resize(_offsets.back());
+            std::vector<uint32_t> next(_offsets.begin(), _offsets.end() - 1);
+            for(uint32_t t = 0; t < net._ntransitions; ++t)
+                for(auto i = net._transitions[t].inputs; i < net._transitions[t].outputs; ++i)
+                    _consumers[next[net._invariants[i].place]++] = t;
+            _changed.reserve(net._nplaces);
+        }
+
+        void update(const MarkVal* marking)
+        {
+            if(_valid)
+            {
+                // give up on the diff once it touches more transitions than a full recompute
+                _changed.clear();
+                size_t work = 0;
+                for(uint32_t p = 0; p < _net._nplaces && work <= _net._ntransitions; ++p)
+                {
+                    if(marking[p] == _marking[p]) continue;
+                    _changed.push_back(p);
+                    work += _offsets[p + 1] - _offsets[p];
+                }
+                if(work <= _net._ntransitions)
+                {
+                    for(auto p : _changed)
+                        _marking[p] = marking[p];
+                    for(auto p : _changed)
+                        for(auto i = _offsets[p]; i < _offsets[p + 1]; ++i)
+                            set(_consumers[i], checkPreset(_consumers[i]));
+                    ++_incremental;
+                    return;
+                }
+            }
+            memcpy(_marking.data(), marking, _net._nplaces * sizeof(MarkVal));
+            std::fill(_enabled.begin(), _enabled.end(), 0);
+            _nenabled = 0;
+            for(uint32_t p = 0; p < _net._nplaces; ++p)
+            {
+                // orphans are currently under "place 0" as a special case
+                if(p != 0 && marking[p] == 0) continue;
+                for(auto t = _net._placeToPtrs[p]; t < _net._placeToPtrs[p + 1]; ++t)
+                    set(t, checkPreset(t));
+            }
+            _valid = true;
+            ++_full;
+        }
+
+        const uint8_t* enabled() const { return _enabled.data(); }
+        size_t nenabled() const { return _nenabled; }
+        size_t incrementalUpdates() const { return _incremental; }
+        size_t fullUpdates() const { return _full; }
+
+    private:
+        bool checkPreset(uint32_t t) const
+        {
+            const TransPtr& ptr = _net._transitions[t];
+            for(auto i = ptr.inputs; i < ptr.outputs; ++i)
+            {
+                const Invariant& inv = _net._invariants[i];
+                if((_marking[inv.place] >= inv.tokens) == inv.inhibitor)
+                    return false;
+            }
+            return true;
+        }
+
+        void set(uint32_t t, bool enabled)
+        {
+            if(_enabled[t] == enabled) return;
+            _enabled[t] = enabled;
+            if(enabled) ++_nenabled;
+            else --_nenabled;
+        }
+
+        const PetriNet& _net;
+        std::vector<MarkVal> _marking;
+        std::vector<uint8_t> _enabled;
+        // transitions with an input or inhibitor arc from place p are
+        // _consumers[_offsets[p]] ... _consumers[_offsets[p+1]-1]
+        std::vector<uint32_t> _offsets;
+        std::vector<uint32_t> _consumers;
+        std::vector<uint32_t> _changed;
+        size_t _nenabled = 0;
+        size_t _incremental = 0;
+        size_t _full = 0;
+        bool _valid = false;
+    };
+}
+
+#endif /* INCREMENTALENABLEDSET_H */
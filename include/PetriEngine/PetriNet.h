@@ -25,6 +25,7 @@
 #include <climits>
 #include <limits>
 #include <iostream>
+#include <mutex>
 
 namespace PetriEngine {
 
@@ -55,6 +56,13 @@ namespace PetriEngine {
     /** Type used for holding markings values */
     typedef uint32_t MarkVal;
 
+    /** Transitions named prefix_0 to prefix_<count-1>, see PetriNetBuilder::addNewTransitions */
+    struct UnnamedTransitions {
+        std::string prefix;
+        uint32_t first;
+        uint32_t count;
+    };
+
     /** Efficient representation of PetriNet */
     class PetriNet {
         PetriNet(uint32_t transitions, uint32_t invariants, uint32_t places);
@@ -79,8 +87,10 @@ namespace PetriEngine {
         int outArc(uint32_t transition, uint32_t place) const;
         
 
+        /** The names of an unfolded net are made on the first call, which may be from any thread */
         const std::vector<std::string>& transitionNames() const
         {
+            std::call_once(_named, [this]{ nameTransitions(); });
             return _transitionnames;
         }
         
@@ -109,14 +119,11 @@ namespace PetriEngine {
         }
 
         bool has_inhibitor() const {
-            for (Invariant i : _invariants) {
-                if (i.inhibitor)
-                    return true;
-            }
-            return false;
+            return _inhibitors;
         }
 
     private:        
+        void nameTransitions() const;
 
         /** Number of x variables
          * @remarks We could also get this from the _places vector, but I don't see any
@@ -128,9 +135,15 @@ namespace PetriEngine {
         std::vector<Invariant> _invariants;
         std::vector<uint32_t> _placeToPtrs;
         MarkVal* _initialMarking;
+        // set by the builder, lets the successor generators skip the inhibitor checks
+        bool _inhibitors = false;
 
-        std::vector<std::string> _transitionnames;
+        mutable std::vector<std::string> _transitionnames;
         std::vector<std::string> _placenames;
+        // blocks of transitions without a name yet and their ids in this net, in the order of the blocks
+        mutable std::vector<UnnamedTransitions> _unnamedtransitions;
+        mutable std::vector<uint32_t> _unnamedids;
+        mutable std::once_flag _named;
 
         std::vector< std::tuple<double, double> > _placelocations;
         std::vector< std::tuple<double, double> > _transitionlocations;
@@ -139,6 +152,8 @@ namespace PetriEngine {
         friend class Reducer;
         friend class SuccessorGenerator;
         friend class ReducingSuccessorGenerator;
+        friend class VectorizedSuccessorGenerator;
+        friend class IncrementalEnabledSet;
         friend class STSolver;
         friend class StubbornSet;
     };
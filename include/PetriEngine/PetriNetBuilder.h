@@ -48,6 +48,17 @@ namespace PetriEngine {
                 int weight) override;
         void addOutputArc(const std::string& transition, const std::string& place, int weight) override;
 
+        /** Add a place whose name is not in use and return its id, exits with an error if the name is in use */
+        uint32_t addNewPlace(const std::string& name, int tokens, double x = 0, double y = 0);
+        /**
+         * Add count transitions named prefix_0 to prefix_<count-1> and return the id of the first.
+         * The names are only made when a name is needed, as in getTransitionNames, and makePetriNet
+         * leaves it to the net to name them on first use.
+         */
+        uint32_t addNewTransitions(const std::string& prefix, uint32_t count);
+        void addInputArc(uint32_t place, uint32_t transition, bool inhibitor, int weight);
+        void addOutputArc(uint32_t transition, uint32_t place, int weight);
+
         virtual void sort() override;
         /** Make the resulting petri net, you take ownership */
         PetriNet* makePetriNet(bool reorder = true);
@@ -65,7 +76,7 @@ namespace PetriEngine {
         
         uint32_t numberOfTransitions() const
         {
-            return _transitionnames.size();
+            return _transitions.size();
         }
         
         const std::unordered_map<std::string, uint32_t>& getPlaceNames() const
@@ -73,11 +84,16 @@ namespace PetriEngine {
             return _placenames;
         }
         
-        const std::unordered_map<std::string, uint32_t>& getTransitionNames() const
+        /** Names the transitions from addNewTransitions, so it is best only called when a name is needed */
+        const std::unordered_map<std::string, uint32_t>& getTransitionNames()
         {
+            nameTransitions();
             return _transitionnames;
         }
 
+        /** Whether some of the queries still refer to transitions by name, as fireability does before it is compiled */
+        static bool needsTransitionNames(const std::vector<std::shared_ptr<PQL::Condition> >& queries);
+
         void reduce(std::vector<std::shared_ptr<PQL::Condition> >& query, 
                     std::vector<Reachability::ResultPrinter::Result>& results, 
                     int reductiontype, bool reconstructTrace, const PetriNet* net, int timeout, std::vector<uint32_t>& reductions);
@@ -129,9 +145,16 @@ namespace PetriEngine {
         std::chrono::high_resolution_clock::time_point _start;
 
     protected:
+        /** Add the names of the transitions from addNewTransitions to _transitionnames */
+        void nameTransitions();
+
         std::unordered_map<std::string, uint32_t> _placenames;
         std::unordered_map<std::string, uint32_t> _transitionnames;
 
+        std::vector<UnnamedTransitions> _unnamedtransitions;
+        // the ids makePetriNet gave the unnamed transitions in the order of the blocks, empty before
+        std::vector<uint32_t> _unnamedids;
+
         std::vector< std::tuple<double, double> > _placelocations;
         std::vector< std::tuple<double, double> > _transitionlocations;
         
@@ -0,0 +1,179 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef EXTERNALBFSSEARCH_H
+#define EXTERNALBFSSEARCH_H
+
+#include "ReachabilitySearch.h"
+#include "../Structures/RunFile.h"
+
+#include <string>
+#include <vector>
+
+namespace PetriEngine {
+    namespace Reachability {
+
+        /**
+         * Breadth first search keeping the state space on disk. Each BFS
+         * layer is a sorted run of AlignedEncoder-encoded markings. The
+         * successors of the frontier are collected in memory-bounded sorted
+         * runs, which are merged against the (sorted) visited states to
+         * obtain the next layer (delayed duplicate detection).
+         * Traces are not supported.
+         */
+        class ExternalBFSSearch {
+        public:
+            ExternalBFSSearch(PetriNet& net, AbstractHandler& callback, const std::string& directory,
+                              size_t memory, int kbound = 0);
+            ~ExternalBFSSearch();
+
+            bool reachable(
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    std::vector<ResultPrinter::Result>& results,
+                    bool usestubborn,
+                    bool statespacesearch,
+                    bool printstats);
+
+        private:
+            template<typename G>
+            bool tryReach(
+                std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                std::vector<ResultPrinter::Result>& results,
+                bool printstats);
+
+            // encodes the marking into the scratchpad, returns 0 if it violates the k-bound
+            size_t encode(const MarkVal* marking);
+            void flushBuffer();
+            std::string newRun();
+            void removeRun(const std::string& run);
+            // merges runs with the visited states, returns the number of new states
+            size_t mergeLayer(std::vector<std::string>& runs);
+            std::string mergeRuns(std::vector<std::string>& runs, size_t from, size_t to);
+            bool checkQueries(std::vector<std::shared_ptr<PQL::Condition > >&,
+                              std::vector<ResultPrinter::Result>&, Structures::State&);
+            std::pair<ResultPrinter::Result,bool> doCallback(std::shared_ptr<PQL::Condition>& query, size_t i,
+                                                              ResultPrinter::Result r);
+            void printStats();
+
+            PetriNet& _net;
+            AbstractHandler& _callback;
+            std::string _directory;
+            size_t _memory;
+            int _kbound;
+            bool _usequeries = true;
+
+            AlignedEncoder _encoder;
+            Structures::io_stats_t _io;
+            Structures::RunBuffer _buffer;
+            std::vector<std::string> _runs;
+            std::string _layer;
+            std::string _visited;
+            size_t _runid = 0;
+
+            Structures::State _initial;
+            std::vector<MarkVal> _maxPlaceBound;
+            std::vector<size_t> _enabledTransitionsCount;
+            uint32_t _maxTokens = 0;
+            size_t _discovered = 0;
+            size_t _explored = 0;
+            size_t _expanded = 0;
+            size_t _layers = 0;
+        };
+
+        template<typename G>
+        bool ExternalBFSSearch::tryReach(std::vector<std::shared_ptr<PQL::Condition> >& queries,
+                                         std::vector<ResultPrinter::Result>& results,
+                                         bool printstats)
+        {
+            Structures::State state;
+            Structures::State working;
+            _initial.setMarking(_net.makeInitialMarking());
+            state.setMarking(_net.makeInitialMarking());
+            working.setMarking(_net.makeInitialMarking());
+            G generator = _makeSucGen<G>(_net, queries);
+
+            // this can fail due to reductions; we push tokens around and violate K
+            auto length = encode(state.marking());
+            if(length > 0)
+            {
+                if(checkQueries(queries, results, state))
+                {
+                    if(printstats) printStats();
+                    return true;
+                }
+                _layer = newRun();
+                {
+                    Structures::RunWriter writer(_layer, _io);
+                    writer.write(_encoder.scratchpad().const_raw(), length);
+                }
+                _visited = newRun();
+                {
+                    Structures::RunWriter writer(_visited, _io);
+                    writer.write(_encoder.scratchpad().const_raw(), length);
+                }
+                _explored = 1;
+
+                size_t layersize = 1;
+                while(layersize > 0)
+                {
+                    {
+                        Structures::RunReader frontier(_layer, _io);
+                        while(frontier.next())
+                        {
+                            _encoder.decode(state.marking(), frontier.data());
+                            generator.prepare(&state);
+                            while(generator.next(working))
+                            {
+                                ++_enabledTransitionsCount[generator.fired()];
+                                auto l = encode(working.marking());
+                                if(l == 0) continue;
+                                _buffer.add(_encoder.scratchpad().const_raw(), l);
+                                if(_buffer.bytes() >= _memory)
+                                    flushBuffer();
+                                // duplicates are only detected when the layer is merged,
+                                // so states can be checked more than once.
+                                if(checkQueries(queries, results, working))
+                                {
+                                    if(printstats) printStats();
+                                    return true;
+                                }
+                            }
+                            ++_expanded;
+                        }
+                    }
+                    flushBuffer();
+                    layersize = mergeLayer(_runs);
+                    _explored += layersize;
+                    ++_layers;
+                }
+            }
+
+            // no more successors, print last results
+            for(size_t i= 0; i < queries.size(); ++i)
+            {
+                if(results[i] == ResultPrinter::Unknown)
+                {
+                    results[i] = doCallback(queries[i], i, ResultPrinter::NotSatisfied).first;
+                }
+            }
+
+            if(printstats) printStats();
+            return false;
+        }
+    }
+}
+
+#endif // EXTERNALBFSSEARCH_H
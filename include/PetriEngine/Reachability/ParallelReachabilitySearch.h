@@ -0,0 +1,253 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PARALLELREACHABILITYSEARCH_H
+#define PARALLELREACHABILITYSEARCH_H
+
+#include "ReachabilitySearch.h"
+#include "../Structures/ConcurrentStateSet.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+
+namespace PetriEngine {
+    namespace Reachability {
+
+        /**
+         * Per-thread work queue of the parallel search. The owner pops in the
+         * order given by the strategy, other threads steal from the opposite
+         * end (or the best element for the heuristic search).
+         */
+        class WorkQueue {
+        public:
+            WorkQueue(Strategy strategy, size_t seed);
+
+            void push(size_t id, uint32_t weight);
+            bool pop(size_t& id);
+            bool steal(size_t& id);
+
+        private:
+            struct weighted_t {
+                uint32_t weight;
+                size_t item;
+                weighted_t(uint32_t w, size_t i) : weight(w), item(i) {};
+                bool operator <(const weighted_t& y) const {
+                    if(weight == y.weight) return item < y.item;
+                    return weight > y.weight;
+                }
+            };
+
+            void flushCache();
+
+            std::mutex _lock;
+            Strategy _strategy;
+            std::deque<size_t> _deque;
+            std::vector<size_t> _cache;
+            std::priority_queue<weighted_t> _heap;
+            std::default_random_engine _rng;
+        };
+
+        /**
+         * Multi-threaded variant of ReachabilitySearch. The threads share a
+         * single ConcurrentStateSet and balance work by stealing from each
+         * others queues. Traces are not supported.
+         */
+        class ParallelReachabilitySearch {
+        public:
+            ParallelReachabilitySearch(PetriNet& net, AbstractHandler& callback, uint32_t threads, int kbound = 0)
+            : _net(net), _kbound(kbound), _threads(std::max<uint32_t>(threads, 1)), _callback(callback) {
+            }
+
+            // check enabledness in SIMD blocks of transitions, only used without stubborn reduction
+            void setVectorized(bool vectorized) { _vectorized = vectorized; }
+
+            // update the enabled transitions of each worker incrementally between the states it expands
+            void setIncremental(bool incremental) { _incremental = incremental; }
+
+            bool reachable(
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    std::vector<ResultPrinter::Result>& results,
+                    Strategy strategy,
+                    bool usestubborn,
+                    bool statespacesearch,
+                    bool printstats,
+                    size_t seed);
+
+        private:
+            struct workerstate_t {
+                size_t heurquery = 0;
+                std::vector<size_t> enabledTransitionsCount;
+            };
+
+            template<typename G>
+            bool tryReach(
+                std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                std::vector<ResultPrinter::Result>& results,
+                Strategy strategy,
+                bool usequeries,
+                bool printstats,
+                size_t seed);
+
+            template<typename G>
+            void work(size_t tid, std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                      std::vector<ResultPrinter::Result>& results, workerstate_t& ws);
+
+            bool findWork(size_t tid, size_t& id);
+            uint32_t weight(Structures::State& state, const PQL::Condition_ptr& query);
+            bool checkQueries(std::vector<std::shared_ptr<PQL::Condition > >&,
+                              std::vector<ResultPrinter::Result>&,
+                              Structures::State&, workerstate_t&);
+            void handle(std::vector<std::shared_ptr<PQL::Condition > >&,
+                        std::vector<ResultPrinter::Result>&, size_t i, ResultPrinter::Result r);
+            void printStats(std::vector<workerstate_t>&);
+
+            PetriNet& _net;
+            int _kbound;
+            uint32_t _threads;
+            AbstractHandler& _callback;
+            bool _usequeries = true;
+            bool _serialeval = false;
+            bool _vectorized = false;
+            bool _incremental = false;
+            Strategy _strategy = HEUR;
+
+            std::unique_ptr<Structures::ConcurrentStateSet> _states;
+            std::vector<std::unique_ptr<WorkQueue>> _queues;
+            std::unique_ptr<std::atomic<bool>[]> _solved;
+            std::atomic<bool> _done;
+            std::atomic<uint32_t> _idle;
+            std::atomic<size_t> _expandedStates;
+            std::atomic<size_t> _exploredStates;
+            std::mutex _query_lock;
+            std::mutex _result_lock;
+        };
+
+        template<typename G>
+        void ParallelReachabilitySearch::work(size_t tid, std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                                              std::vector<ResultPrinter::Result>& results, workerstate_t& ws)
+        {
+            Structures::State state;
+            Structures::State working;
+            state.setMarking(_net.makeInitialMarking());
+            working.setMarking(_net.makeInitialMarking());
+            G generator = _makeSucGen<G>(_net, queries, &_query_lock);
+            generator.setIncremental(_incremental);
+            auto& queue = *_queues[tid];
+
+            size_t id;
+            while(!_done && findWork(tid, id))
+            {
+                _states->decode(state, id, tid);
+                generator.prepare(&state);
+                while(!_done && generator.next(working))
+                {
+                    ws.enabledTransitionsCount[generator.fired()]++;
+                    auto res = _states->add(working, tid);
+                    if(!res.first) continue;
+                    ++_exploredStates;
+                    queue.push(res.second, weight(working, queries[ws.heurquery]));
+                    if(checkQueries(queries, results, working, ws))
+                    {
+                        _done = true;
+                        break;
+                    }
+                }
+                ++_expandedStates;
+            }
+        }
+
+        template<typename G>
+        bool ParallelReachabilitySearch::tryReach(std::vector<std::shared_ptr<PQL::Condition> >& queries,
+                                                  std::vector<ResultPrinter::Result>& results,
+                                                  Strategy strategy, bool usequeries,
+                                                  bool printstats, size_t seed)
+        {
+            _strategy = strategy;
+            _usequeries = usequeries;
+            _done = false;
+            _idle = 0;
+            _expandedStates = 0;
+            _exploredStates = 1;
+            _states = std::make_unique<Structures::ConcurrentStateSet>(_net, _kbound, _threads * 4, _threads);
+            _queues.clear();
+            for(size_t i = 0; i < _threads; ++i)
+                _queues.emplace_back(std::make_unique<WorkQueue>(strategy, seed + i));
+            _solved = std::make_unique<std::atomic<bool>[]>(queries.size());
+            _serialeval = false;
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                _solved[i] = results[i] != ResultPrinter::Unknown;
+                _serialeval |= queries[i]->getQuantifier() == PQL::Quantifier::UPPERBOUNDS;
+            }
+
+            std::vector<workerstate_t> ws(_threads);
+            for(size_t i = 0; i < _threads; ++i)
+            {
+                ws[i].enabledTransitionsCount.resize(_net.numberOfTransitions(), 0);
+                ws[i].heurquery = queries.size() >= 2 ? (std::rand() + i) % queries.size() : 0;
+            }
+
+            Structures::State initial;
+            initial.setMarking(_net.makeInitialMarking());
+            auto r = _states->add(initial, 0);
+            // this can fail due to reductions; we push tokens around and violate K
+            if(r.first)
+            {
+                if(checkQueries(queries, results, initial, ws[0]))
+                {
+                    if(printstats) printStats(ws);
+                    return true;
+                }
+                _queues[0]->push(r.second, weight(initial, queries[ws[0].heurquery]));
+
+                std::vector<std::thread> threads;
+                for(size_t i = 0; i < _threads; ++i)
+                {
+                    threads.emplace_back([&, i]() {
+                        work<G>(i, queries, results, ws[i]);
+                    });
+                }
+                for(auto& t : threads)
+                    t.join();
+            }
+
+            bool alldone = true;
+            for(size_t i = 0; i < queries.size(); ++i)
+                alldone &= _solved[i];
+            if(alldone && _usequeries)
+            {
+                if(printstats) printStats(ws);
+                return true;
+            }
+
+            // no more successors, print last results
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                if(results[i] == ResultPrinter::Unknown)
+                    handle(queries, results, i, ResultPrinter::NotSatisfied);
+            }
+
+            if(printstats) printStats(ws);
+            return false;
+        }
+    }
+}
+
+#endif // PARALLELREACHABILITYSEARCH_H
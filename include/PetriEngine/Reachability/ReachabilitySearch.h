@@ -25,12 +25,19 @@
 #include "../PQL/PQL.h"
 #include "../PetriNet.h"
 #include "../Structures/StateSet.h"
+#include "../Structures/BitStateSet.h"
+#include "../Structures/ColoredStateSet.h"
 #include "../Structures/Queue.h"
 #include "../SuccessorGenerator.h"
 #include "../ReducingSuccessorGenerator.h"
+#include "../VectorizedSuccessorGenerator.h"
+#include "../Colored/ColoredSuccessorGenerator.h"
 #include "PetriEngine/Stubborn/ReachabilityStubbornSet.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 #include <PetriEngine/Stubborn/ReachabilityStubbornSet.h>
 
@@ -43,10 +50,25 @@ namespace PetriEngine {
             DFS,
             HEUR,
             RDFS,
+            ASTAR,
+            BEAM,
+            RESTART,
             OverApprox,
             DEFAULT
         };
         
+        template <typename G>
+        inline G _makeSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries, std::mutex* query_lock = nullptr) {
+            return G{net, queries};
+        }
+        template <>
+        inline ReducingSuccessorGenerator _makeSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries, std::mutex* query_lock) {
+            auto stubset = std::make_shared<ReachabilityStubbornSet>(net, queries);
+            stubset->setInterestingVisitor<InterestingTransitionVisitor>();
+            stubset->setQueryLock(query_lock);
+            return ReducingSuccessorGenerator{net, stubset};
+        }
+
         /** Implements reachability check in a BFS manner using a hash table */
         class ReachabilitySearch {
         public:
@@ -69,6 +91,32 @@ namespace PetriEngine {
                     bool printstats,
                     bool keep_trace,
                     size_t seed);
+
+            // used when the queries are shared with searches running in other threads
+            void setQueryLock(std::mutex* lock) { _query_lock = lock; }
+
+            // the search gives up (without answering) once the flag is raised
+            void setStopFlag(const std::atomic<bool>* stop) { _stop = stop; }
+
+            // store only a bitstate filter of 2^bits bits instead of the exact markings,
+            // 0 disables. The search is then possibly incomplete.
+            void setBitstate(uint32_t bits, uint32_t hashes) { _bitstate_bits = bits; _bitstate_hashes = hashes; }
+
+            // check enabledness in SIMD blocks of transitions, only used without stubborn reduction
+            void setVectorized(bool vectorized) { _vectorized = vectorized; }
+
+            // update the enabled transitions incrementally between consecutive states
+            void setIncremental(bool incremental) { _incremental = incremental; }
+
+            // number of states kept by the beam search
+            void setBeamWidth(size_t width) { _beam_width = width; }
+
+            // pops between the random restarts of the restarting heuristic search
+            void setRestartInterval(size_t interval) { _restart_interval = interval; }
+
+            // search the colored net directly, the net searched must be the one made by stripColors of builder.
+            // The markings of the net are the number of tokens of the colored places, traces are not supported.
+            void setColoredNet(const ColoredPetriNetBuilder* builder) { _colored = builder; }
         private:
             struct searchstate_t {
                 size_t expandedStates = 0;
@@ -78,7 +126,7 @@ namespace PetriEngine {
                 bool usequeries;
             };
             
-            template<typename Q, typename W = Structures::StateSet, typename G>
+            template<typename Q, typename W = Structures::StateSet, typename G, typename S = Structures::State>
             bool tryReach(
                 std::vector<std::shared_ptr<PQL::Condition > >& queries,
                 std::vector<ResultPrinter::Result>& results,
@@ -90,26 +138,56 @@ namespace PetriEngine {
                                     std::vector<ResultPrinter::Result>&,
                                     Structures::State&, searchstate_t&, Structures::StateSetInterface*);
             std::pair<ResultPrinter::Result,bool> doCallback(std::shared_ptr<PQL::Condition>& query, size_t i, ResultPrinter::Result r, searchstate_t &ss, Structures::StateSetInterface *states);
+            bool stopped() const { return _stop != nullptr && _stop->load(std::memory_order_relaxed); }
+
+            template<typename Q>
+            Q makeQueue(Structures::StateSetInterface* states, size_t seed)
+            {
+                if constexpr (std::is_same_v<Q, Structures::BeamQueue>)
+                    return Q(states, seed, _beam_width);
+                else if constexpr (std::is_same_v<Q, Structures::RandomRestartQueue>)
+                    return Q(states, seed, _restart_interval);
+                else
+                    return Q(states, seed);
+            }
+
+            template<typename W>
+            std::unique_ptr<W> makeStateSet()
+            {
+                if constexpr (std::is_same_v<W, Structures::BitStateSet>)
+                    return std::make_unique<W>(_net, _kbound, _bitstate_bits, _bitstate_hashes);
+                else if constexpr (std::is_same_v<W, Structures::ColoredStateSet>)
+                    return std::make_unique<W>(_net, _kbound, *_colored);
+                else
+                    return std::make_unique<W>(_net, _kbound);
+            }
+
+            template<typename G>
+            G makeSuccessorGenerator(std::vector<PQL::Condition_ptr>& queries)
+            {
+                if constexpr (std::is_same_v<G, Colored::ColoredSuccessorGenerator>)
+                    return G{_net, *_colored};
+                else
+                    return _makeSucGen<G>(_net, queries, _query_lock);
+            }
             
             PetriNet& _net;
             int _kbound;
             size_t _satisfyingMarking = 0;
             Structures::State _initial;
             AbstractHandler& _callback;
+            std::mutex* _query_lock = nullptr;
+            const std::atomic<bool>* _stop = nullptr;
+            uint32_t _bitstate_bits = 0;
+            uint32_t _bitstate_hashes = 3;
+            bool _vectorized = false;
+            bool _incremental = false;
+            size_t _beam_width = 10000;
+            size_t _restart_interval = 1000;
+            const ColoredPetriNetBuilder* _colored = nullptr;
         };
 
-        template <typename G>
-        inline G _makeSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries) {
-            return G{net, queries};
-        }
-        template <>
-        inline ReducingSuccessorGenerator _makeSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries) {
-            auto stubset = std::make_shared<ReachabilityStubbornSet>(net, queries);
-            stubset->setInterestingVisitor<InterestingTransitionVisitor>();
-            return ReducingSuccessorGenerator{net, stubset};
-        }
-
-        template<typename Q, typename W, typename G>
+        template<typename Q, typename W, typename G, typename S>
         bool ReachabilitySearch::tryReach(   std::vector<std::shared_ptr<PQL::Condition> >& queries,
                                         std::vector<ResultPrinter::Result>& results, bool usequeries,
                                         bool printstats, size_t seed)
@@ -124,15 +202,22 @@ namespace PetriEngine {
             ss.usequeries = usequeries;
 
             // set up working area
-            Structures::State state;
-            Structures::State working;
+            S state;
+            S working;
             _initial.setMarking(_net.makeInitialMarking());
             state.setMarking(_net.makeInitialMarking());
             working.setMarking(_net.makeInitialMarking());
             
-            W states(_net, _kbound);    // stateset
-            Q queue(&states, seed);           // working queue
-            G generator = _makeSucGen<G>(_net, queries); // successor generator
+            auto stateset = makeStateSet<W>();
+            W& states = *stateset;      // stateset
+            Q queue = makeQueue<Q>(&states, seed); // working queue
+            G generator = makeSuccessorGenerator<G>(queries); // successor generator
+            generator.setIncremental(_incremental);
+            if constexpr (std::is_same_v<S, Structures::ColoredState>)
+            {
+                generator.initialize(state);
+                generator.initialize(working);
+            }
             auto r = states.add(state);
             // this can fail due to reductions; we push tokens around and violate K
             if(r.first){ 
@@ -154,7 +239,7 @@ namespace PetriEngine {
                 }
 
                 // Search!
-                while (queue.pop(state)) {
+                while (!stopped() && queue.pop(state)) {
                     generator.prepare(&state);
 
                     while(generator.next(working)){
@@ -178,6 +263,10 @@ namespace PetriEngine {
                 }
             }
 
+            // another search answered the remaining queries
+            if(stopped())
+                return false;
+
             // no more successors, print last results
             for(size_t i= 0; i < queries.size(); ++i)
             {
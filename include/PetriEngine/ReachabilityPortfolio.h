@@ -0,0 +1,99 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef REACHABILITYPORTFOLIO_H
+#define REACHABILITYPORTFOLIO_H
+
+#include "PetriEngine/PetriNet.h"
+#include "PetriEngine/options.h"
+#include "PetriEngine/PQL/PQL.h"
+#include "PetriEngine/Reachability/ReachabilityResult.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace PetriEngine {
+    class Reducer;
+
+    /**
+     * Races several reachability engines (explicit searches with different
+     * strategies, TAR and siphon-trap analysis) against each other on the
+     * same net and queries, one engine per thread. The first engine to
+     * decide a query answers it; the others are stopped as soon as all
+     * queries have been answered.
+     */
+    class ReachabilityPortfolio {
+    public:
+        using Result = Reachability::AbstractHandler::Result;
+
+        ReachabilityPortfolio(Reachability::AbstractHandler& printer, PetriNet& net, Reducer* reducer, options_t& options)
+        : _printer(printer), _net(net), _reducer(reducer), _options(options) {}
+
+        void reachable(std::vector<PQL::Condition_ptr>& queries, std::vector<Result>& results);
+
+        // upper-bounds queries are updated during evaluation and cannot be shared between engines
+        static bool supports(const std::vector<PQL::Condition_ptr>& queries);
+
+    private:
+        enum member_t {
+            HEUR,
+            RDFS,
+            BFS,
+            DFS,
+            TAR,
+            SIPHON_TRAP
+        };
+
+        class handler_t : public Reachability::AbstractHandler {
+        public:
+            handler_t(ReachabilityPortfolio& portfolio, member_t member)
+            : _portfolio(portfolio), _member(member) {}
+
+            std::pair<Result, bool> handle(
+                size_t index,
+                PQL::Condition* query,
+                Result result,
+                const std::vector<uint32_t>* maxPlaceBound = nullptr,
+                size_t expandedStates = 0,
+                size_t exploredStates = 0,
+                size_t discoveredStates = 0,
+                int maxTokens = 0,
+                Structures::StateSetInterface* stateset = nullptr, size_t lastmarking = 0, const MarkVal* initialMarking = nullptr) override;
+        private:
+            ReachabilityPortfolio& _portfolio;
+            member_t _member;
+        };
+
+        std::vector<member_t> members(const std::vector<PQL::Condition_ptr>& queries, const std::vector<Result>& results) const;
+        void run(member_t member, std::vector<PQL::Condition_ptr>& queries, std::vector<Result> results);
+        static const char* name(member_t member);
+
+        Reachability::AbstractHandler& _printer;
+        PetriNet& _net;
+        Reducer* _reducer;
+        options_t& _options;
+
+        std::mutex _query_lock;
+        std::mutex _result_lock;
+        std::vector<Result> _results;
+        std::vector<bool> _answered;
+        size_t _remaining = 0;
+        std::atomic<bool> _stop;
+    };
+}
+
+#endif // REACHABILITYPORTFOLIO_H
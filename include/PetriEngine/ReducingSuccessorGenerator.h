@@ -26,6 +26,8 @@ namespace PetriEngine {
 
         void setQuery(PQL::Condition *ptr) { _stubSet->setQuery(ptr); }
 
+        void setIncremental(bool incremental) override { _stubSet->setIncremental(incremental); }
+
         bool prepare(const Structures::State *state) override;
 
         bool next(Structures::State &write);
@@ -4,6 +4,7 @@
 #include "Reachability/ReachabilityResult.h"
 #include "TAR/AntiChain.h"
 
+#include <atomic>
 #include <memory>
 #include <chrono>
 
@@ -24,10 +25,13 @@ namespace PetriEngine {
     };
         
     public:
-        STSolver(Reachability::ResultPrinter& printer, const PetriNet& net, PQL::Condition * query, uint32_t depth);
+        STSolver(Reachability::AbstractHandler& printer, const PetriNet& net, PQL::Condition * query, uint32_t depth);
         virtual ~STSolver();
         bool solve(uint32_t timeout);
-        Reachability::ResultPrinter::Result printResult();
+        Reachability::ResultPrinter::Result printResult(size_t index);
+
+        // the analysis gives up as if timed out once the flag is raised
+        void setStopFlag(const std::atomic<bool>* stop) { _stop = stop; }
         
     private:    
         size_t computeTrap(std::vector<size_t>& siphon, const std::set<size_t>& pre, const std::set<size_t>& post, size_t marked_count);
@@ -37,7 +41,7 @@ namespace PetriEngine {
         void constructPrePost();
         void extend(size_t place, std::set<size_t>& pre, std::set<size_t>& post);
         bool _siphonPropperty = false;
-        Reachability::ResultPrinter& printer;
+        Reachability::AbstractHandler& printer;
         PQL::Condition * _query;
         std::unique_ptr<place_t[]> _places;
         std::unique_ptr<uint32_t[]> _transitions;
@@ -49,6 +53,7 @@ namespace PetriEngine {
         uint32_t _analysisTime;
         std::chrono::high_resolution_clock::time_point _start;
         AntiChain<size_t, size_t> _antichain;
+        const std::atomic<bool>* _stop = nullptr;
     };
 }
 #endif /* STSOLVER_H */
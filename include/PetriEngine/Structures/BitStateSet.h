@@ -0,0 +1,173 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BITSTATESET_H
+#define BITSTATESET_H
+
+#include "StateSet.h"
+#include "../Simplification/MurmurHash2.h"
+
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        /**
+         * Bloom filter over encoded states (bitstate hashing). A state is
+         * remembered by setting k bits in a table of 2^bits bits, the k
+         * positions are derived from two hashes by double hashing.
+         * Distinct states may collide, so a state can wrongly be reported as
+         * seen; a search using the filter is hence possibly incomplete.
+         */
+        class BitStateFilter {
+        public:
+            BitStateFilter(uint32_t bits, uint32_t hashes)
+            : _mask((size_t{1} << bits) - 1), _hashes(std::max<uint32_t>(hashes, 1)),
+              _table(std::max<size_t>((size_t{1} << bits) / 64, 1), 0)
+            {
+            }
+
+            /** Insert a key, returns true if it was not in the filter already */
+            bool insert(const void* key, size_t length)
+            {
+                uint64_t h1, h2;
+                hash(key, length, h1, h2);
+                bool isnew = false;
+                for(uint32_t i = 0; i < _hashes; ++i)
+                {
+                    auto bit = (h1 + i * h2) & _mask;
+                    auto& word = _table[bit / 64];
+                    uint64_t m = uint64_t{1} << (bit % 64);
+                    isnew |= (word & m) == 0;
+                    word |= m;
+                }
+                return isnew;
+            }
+
+            bool contains(const void* key, size_t length) const
+            {
+                uint64_t h1, h2;
+                hash(key, length, h1, h2);
+                for(uint32_t i = 0; i < _hashes; ++i)
+                {
+                    auto bit = (h1 + i * h2) & _mask;
+                    if((_table[bit / 64] & (uint64_t{1} << (bit % 64))) == 0)
+                        return false;
+                }
+                return true;
+            }
+
+            size_t bytes() const { return _table.size() * sizeof(uint64_t); }
+
+        private:
+            static void hash(const void* key, size_t length, uint64_t& h1, uint64_t& h2)
+            {
+                h1 = MurmurHash64A(key, length, 0x9e3779b97f4a7c15ULL);
+                // odd, so all positions of the table can be reached
+                h2 = MurmurHash64A(key, length, 0xc6a4a7935bd1e995ULL) | 1;
+            }
+
+            size_t _mask;
+            uint32_t _hashes;
+            std::vector<uint64_t> _table;
+        };
+
+        /**
+         * State set storing only a bitstate filter of the visited states.
+         * The encoding of a new state is kept until the search releases it
+         * (i.e. while it is waiting to be expanded), so memory is
+         * proportional to the frontier rather than the state space.
+         * Traces are not supported.
+         */
+        class BitStateSet : public StateSetInterface {
+        public:
+            BitStateSet(const PetriNet& net, uint32_t kbound, uint32_t bits, uint32_t hashes)
+            : StateSetInterface(net, kbound), _store(bits, hashes)
+            {
+            }
+
+            virtual std::pair<bool, size_t> add(const State& state) override
+            {
+                return _add(state, _store);
+            }
+
+            virtual void decode(State& state, size_t id) override
+            {
+                _decode(state, id, _store);
+            }
+
+            virtual std::pair<bool, size_t> lookup(State& state) override
+            {
+                return _lookup(state, _store);
+            }
+
+            virtual void setHistory(size_t id, size_t transition) override {}
+
+            virtual std::pair<size_t, size_t> getHistory(size_t markingid) override
+            {
+                assert(false);
+                return std::make_pair(0,0);
+            }
+
+            virtual void release(size_t id) override
+            {
+                _store._pending.erase(id);
+            }
+
+            virtual bool complete() const override { return false; }
+
+        private:
+            // gives the filter the interface of a ptrie, as used by _add, _decode and _lookup
+            struct store_t {
+                store_t(uint32_t bits, uint32_t hashes) : _filter(bits, hashes) {}
+
+                std::pair<bool, size_t> insert(const unsigned char* data, size_t length)
+                {
+                    if(!_filter.insert(data, length))
+                        return std::make_pair(false, std::numeric_limits<size_t>::max());
+                    auto id = _next++;
+                    _pending.emplace(id, std::vector<unsigned char>(data, data + length));
+                    return std::make_pair(true, id);
+                }
+
+                std::pair<bool, size_t> exists(const unsigned char* data, size_t length) const
+                {
+                    return std::make_pair(_filter.contains(data, length), std::numeric_limits<size_t>::max());
+                }
+
+                void unpack(size_t id, unsigned char* destination) const
+                {
+                    auto it = _pending.find(id);
+                    assert(it != _pending.end());
+                    memcpy(destination, it->second.data(), it->second.size());
+                }
+
+                size_t size() const { return _next; }
+
+                BitStateFilter _filter;
+                std::unordered_map<size_t, std::vector<unsigned char>> _pending;
+                size_t _next = 0;
+            };
+
+            store_t _store;
+        };
+    }
+}
+
+#endif // BITSTATESET_H
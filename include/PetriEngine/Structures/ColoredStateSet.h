@@ -0,0 +1,204 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef COLOREDSTATESET_H
+#define COLOREDSTATESET_H
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "StateSet.h"
+#include "../Colored/ColoredPetriNetBuilder.h"
+
+namespace PetriEngine {
+    namespace Structures {
+
+        /** State of a search on a colored net. Besides the colored tokens of every colored place
+         * it keeps their number as the marking of the net made by ColoredPetriNetBuilder::stripColors,
+         * which the queries are evaluated on. */
+        class ColoredState : public State {
+        public:
+            std::vector<Colored::Multiset>& places() {
+                return _places;
+            }
+
+            const std::vector<Colored::Multiset>& places() const {
+                return _places;
+            }
+
+        private:
+            std::vector<Colored::Multiset> _places;
+        };
+
+        /** The place of the stripped net for every colored place, the net may have reordered them */
+        inline std::vector<uint32_t> strippedPlaceIds(const PetriNet& net, const std::vector<Colored::Place>& places)
+        {
+            std::unordered_map<std::string, uint32_t> ids;
+            for (uint32_t i = 0; i < net.numberOfPlaces(); ++i)
+                ids[net.placeNames()[i]] = i;
+            std::vector<uint32_t> res;
+            res.reserve(places.size());
+            for (auto& place : places)
+            {
+                assert(ids.count(place.name) == 1);
+                res.push_back(ids[place.name]);
+            }
+            return res;
+        }
+
+        /** Stores colored markings. Every place is encoded as its number of distinct colors
+         * followed by the sorted color ids and their counts. */
+        class ColoredStateSet : public StateSetInterface {
+        private:
+            using ptrie_t = ptrie::set_stable<ptrie::uchar,17,128,4>;
+
+        public:
+            ColoredStateSet(const PetriNet& net, uint32_t kbound, const ColoredPetriNetBuilder& builder)
+            : StateSetInterface(net, kbound), _places(builder.getPlaces()), _placeIds(strippedPlaceIds(net, _places))
+            {
+            }
+
+            virtual std::pair<bool, size_t> add(const State& state) override
+            {
+                _discovered++;
+
+                MarkVal sum = 0;
+                for (uint32_t i = 0; i < _net.numberOfPlaces(); ++i)
+                    sum += state.marking()[i];
+
+                if (_maxTokens < sum)
+                    _maxTokens = sum;
+
+                //Check that we're within k-bound
+                if (_kbound != 0 && sum > _kbound)
+                    return std::pair<bool, size_t>(false, std::numeric_limits<size_t>::max());
+
+                encode(static_cast<const ColoredState&>(state));
+                if(_scratch.size()*8 >= std::numeric_limits<uint16_t>::max())
+                {
+                    std::cerr << "error: Marking could not be encoded into less than 2^16 bytes, current limit of PTries" << std::endl;
+                    std::exit(-1);
+                }
+                auto tit = _trie.insert(_scratch.data(), _scratch.size());
+                if(!tit.first)
+                {
+                    return std::pair<bool, size_t>(false, tit.second);
+                }
+                _buffer.resize(std::max(_buffer.size(), _scratch.size()));
+
+                // update the max token bound for each place in the net (only for newly discovered markings)
+                for (uint32_t i = 0; i < _net.numberOfPlaces(); i++)
+                {
+                    _maxPlaceBound[i] = std::max<MarkVal>(state.marking()[i], _maxPlaceBound[i]);
+                }
+                return std::pair<bool, size_t>(true, tit.second);
+            }
+
+            virtual void decode(State& state, size_t id) override
+            {
+                auto& colored = static_cast<ColoredState&>(state);
+                colored.places().resize(_places.size());
+                _trie.unpack(id, _buffer.data());
+                const ptrie::uchar* data = _buffer.data();
+                for (size_t p = 0; p < _places.size(); ++p)
+                {
+                    auto& ms = colored.places()[p];
+                    ms.clear();
+                    MarkVal sum = 0;
+                    for (uint32_t n = read(data); n > 0; --n)
+                    {
+                        uint32_t color = read(data);
+                        uint32_t count = read(data);
+                        ms[&(*_places[p].type)[color]] = count;
+                        sum += count;
+                    }
+                    state.marking()[_placeIds[p]] = sum;
+                }
+            }
+
+            virtual std::pair<bool, size_t> lookup(State& state) override
+            {
+                encode(static_cast<const ColoredState&>(state));
+                auto tit = _trie.exists(_scratch.data(), _scratch.size());
+                if (tit.first) {
+                    return tit;
+                }
+                else return std::make_pair(false, std::numeric_limits<size_t>::max());
+            }
+
+            virtual void setHistory(size_t id, size_t transition) override {}
+
+            virtual std::pair<size_t, size_t> getHistory(size_t markingid) override
+            {
+                assert(false);
+                return std::make_pair(0,0);
+            }
+
+        private:
+            void encode(const ColoredState& state)
+            {
+                _scratch.clear();
+                for (auto& ms : state.places())
+                {
+                    // the colors of a multiset are sorted by their id
+                    _entries.clear();
+                    for (auto c : ms)
+                    {
+                        if (c.second > 0)
+                            _entries.emplace_back(c.first->getId(), c.second);
+                    }
+                    write(_entries.size());
+                    for (auto& e : _entries)
+                    {
+                        write(e.first);
+                        write(e.second);
+                    }
+                }
+            }
+
+            // ids and counts are mostly small, so they are written 7 bits at a time
+            void write(uint32_t val)
+            {
+                while (val >= 0x80)
+                {
+                    _scratch.push_back((val & 0x7F) | 0x80);
+                    val >>= 7;
+                }
+                _scratch.push_back(val);
+            }
+
+            static uint32_t read(const ptrie::uchar*& data)
+            {
+                uint32_t val = 0;
+                for (uint32_t shift = 0; ; shift += 7)
+                {
+                    val |= (uint32_t)(*data & 0x7F) << shift;
+                    if ((*data++ & 0x80) == 0)
+                        return val;
+                }
+            }
+
+            ptrie_t _trie;
+            const std::vector<Colored::Place>& _places;
+            std::vector<uint32_t> _placeIds;
+            std::vector<std::pair<uint32_t, uint32_t>> _entries;
+            std::vector<ptrie::uchar> _scratch;
+            std::vector<ptrie::uchar> _buffer;
+        };
+    }
+}
+
+#endif // COLOREDSTATESET_H
@@ -0,0 +1,83 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CONCURRENTSTATESET_H
+#define CONCURRENTSTATESET_H
+
+#include "State.h"
+#include "AlignedEncoder.h"
+#include "../PetriNet.h"
+
+#include <ptrie/ptrie_stable.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        /**
+         * State set which can be shared between threads.
+         * Encoded markings are partitioned by their hash into a number of
+         * independently locked ptrie shards. Every thread has its own
+         * encoder and statistics, so only the trie operations themselves
+         * are done under a lock. Ids are interleaved over the shards,
+         * i.e. the shard of an id is id % shards.
+         */
+        class ConcurrentStateSet {
+        public:
+            ConcurrentStateSet(const PetriNet& net, uint32_t kbound, uint32_t shards, uint32_t threads);
+
+            std::pair<bool, size_t> add(const State& state, size_t tid);
+
+            void decode(State& state, size_t id, size_t tid);
+
+            const PetriNet& net() const { return _net; }
+
+            size_t discovered() const;
+
+            uint32_t maxTokens() const;
+
+            std::vector<MarkVal> maxPlaceBound() const;
+
+        private:
+            using ptrie_t = ptrie::set_stable<ptrie::uchar,17,128,4>;
+
+            struct shard_t {
+                std::mutex _lock;
+                ptrie_t _trie;
+            };
+
+            // written by the owning thread only, read when merging
+            struct alignas(64) thread_t {
+                thread_t(uint32_t nplaces, uint32_t kbound);
+                AlignedEncoder _encoder;
+                std::atomic<size_t> _discovered;
+                std::atomic<uint32_t> _maxTokens;
+                std::unique_ptr<std::atomic<MarkVal>[]> _maxPlaceBound;
+            };
+
+            const PetriNet& _net;
+            uint32_t _kbound;
+            std::vector<std::unique_ptr<shard_t>> _shards;
+            std::vector<std::unique_ptr<thread_t>> _threads;
+        };
+    }
+}
+
+#endif // CONCURRENTSTATESET_H
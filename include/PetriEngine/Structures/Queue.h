@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <queue>
+#include <set>
 #include <stack>
 #include <random>
 
@@ -103,6 +104,90 @@ namespace PetriEngine {
         private:
             std::priority_queue<weighted_t> _queue;
         };
+
+        /**
+         * Orders states by depth + distance, ties broken by distance.
+         * The depth of a state is one more than the depth of the state
+         * popped before it was pushed.
+         */
+        class AStarQueue : public Queue {
+        public:
+            struct weighted_t {
+                uint32_t cost;
+                uint32_t distance;
+                uint32_t depth;
+                uint32_t item;
+                weighted_t(uint32_t c, uint32_t d, uint32_t dp, uint32_t i) : cost(c), distance(d), depth(dp), item(i) {};
+                bool operator <(const weighted_t& y) const {
+                    if(cost != y.cost) return cost > y.cost;
+                    if(distance != y.distance) return distance > y.distance;
+                    return item < y.item;
+                }
+            };
+
+            AStarQueue(StateSetInterface* states, size_t);
+            virtual ~AStarQueue();
+
+            virtual bool pop(Structures::State& state);
+            virtual void push(size_t id, PQL::DistanceContext&,
+                std::shared_ptr<PQL::Condition>& query);
+        private:
+            std::priority_queue<weighted_t> _queue;
+            uint32_t _depth = 0;
+        };
+
+        /**
+         * Heuristic search keeping at most width states in the queue,
+         * the ones furthest from the goal are dropped. Dropping states
+         * marks the state set as incomplete.
+         */
+        class BeamQueue : public Queue {
+        public:
+            BeamQueue(StateSetInterface* states, size_t, size_t width);
+            virtual ~BeamQueue();
+
+            virtual bool pop(Structures::State& state);
+            virtual void push(size_t id, PQL::DistanceContext&,
+                std::shared_ptr<PQL::Condition>& query);
+        private:
+            // begin() is the worst state, rbegin() the best
+            std::set<HeuristicQueue::weighted_t> _queue;
+            size_t _width;
+        };
+
+        /**
+         * Heuristic search that every interval pops continues from a random
+         * state of the queue. States pushed after a restart are preferred
+         * over older ones, so the search dives from the random state until
+         * the next restart. No state is dropped.
+         */
+        class RandomRestartQueue : public Queue {
+        public:
+            struct weighted_t {
+                uint32_t epoch;
+                uint32_t weight;
+                uint32_t item;
+                weighted_t(uint32_t e, uint32_t w, uint32_t i) : epoch(e), weight(w), item(i) {};
+                bool operator <(const weighted_t& y) const {
+                    if(epoch != y.epoch) return epoch < y.epoch;
+                    if(weight != y.weight) return weight > y.weight;
+                    return item < y.item;
+                }
+            };
+
+            RandomRestartQueue(StateSetInterface* states, size_t seed, size_t interval);
+            virtual ~RandomRestartQueue();
+
+            virtual bool pop(Structures::State& state);
+            virtual void push(size_t id, PQL::DistanceContext&,
+                std::shared_ptr<PQL::Condition>& query);
+        private:
+            std::vector<weighted_t> _heap;
+            std::default_random_engine _rng;
+            size_t _interval;
+            size_t _pops = 0;
+            uint32_t _epoch = 0;
+        };
     }
 }
 
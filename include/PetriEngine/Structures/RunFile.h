@@ -0,0 +1,101 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RUNFILE_H
+#define RUNFILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        struct io_stats_t {
+            size_t bytesRead = 0;
+            size_t bytesWritten = 0;
+            double seconds = 0;
+        };
+
+        /**
+         * A run is a file of length-prefixed records (encoded markings),
+         * written and read sequentially in large blocks. The I/O done is
+         * accumulated in the given statistics.
+         */
+        class RunWriter {
+        public:
+            RunWriter(const std::string& path, io_stats_t& stats);
+            ~RunWriter();
+
+            void write(const unsigned char* data, uint16_t length);
+            void close();
+
+            size_t records() const { return _records; }
+        private:
+            void flush();
+
+            FILE* _file = nullptr;
+            io_stats_t& _stats;
+            std::vector<unsigned char> _buffer;
+            size_t _records = 0;
+        };
+
+        class RunReader {
+        public:
+            RunReader(const std::string& path, io_stats_t& stats);
+            ~RunReader();
+
+            /** Advance to the next record, false at the end of the run */
+            bool next();
+
+            const unsigned char* data() const { return _record.data(); }
+            uint16_t length() const { return _length; }
+        private:
+            bool read(unsigned char* dest, size_t n);
+            bool fill();
+
+            FILE* _file = nullptr;
+            io_stats_t& _stats;
+            std::vector<unsigned char> _buffer;
+            size_t _pos = 0;
+            size_t _end = 0;
+            std::vector<unsigned char> _record;
+            uint16_t _length = 0;
+        };
+
+        /**
+         * In-memory batch of records, sorted and deduplicated before it is
+         * written as a run.
+         */
+        class RunBuffer {
+        public:
+            void add(const unsigned char* data, uint16_t length);
+            size_t bytes() const { return _data.size() + _offsets.size() * sizeof(size_t); }
+            bool empty() const { return _offsets.empty(); }
+            void write(RunWriter& writer);
+            void clear();
+        private:
+            std::vector<unsigned char> _data;
+            std::vector<size_t> _offsets;
+        };
+
+        /** Total order on records used for all runs */
+        int compareRecords(const unsigned char* a, uint16_t alen, const unsigned char* b, uint16_t blen);
+    }
+}
+
+#endif // RUNFILE_H
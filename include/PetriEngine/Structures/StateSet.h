@@ -60,7 +60,18 @@ namespace PetriEngine {
             
             virtual std::pair<size_t, size_t> getHistory(size_t markingid) = 0;
 
+            // the state will not be decoded again
+            virtual void release(size_t id) {}
+
+            // false if states can wrongly be reported as already seen,
+            // or if the search dropped some of them
+            virtual bool complete() const { return !_pruned; }
+
+            // the search discarded states without exploring them
+            void setPruned() { _pruned = true; }
+
         protected:
+            bool _pruned = false;
             size_t _discovered;
             uint32_t _kbound;
             uint32_t _maxTokens;
@@ -22,6 +22,8 @@
 #include "PetriEngine/Stubborn/StubbornSet.h"
 #include "InterestingTransitionVisitor.h"
 
+#include <mutex>
+
 namespace PetriEngine {
     class ReachabilityStubbornSet : public StubbornSet {
     public:
@@ -43,8 +45,12 @@ namespace PetriEngine {
             _interesting = std::make_unique<TVisitor>(*this, _closure);
         }
 
+        // the queries are annotated during prepare, guard them if they are shared between threads
+        void setQueryLock(std::mutex* lock) { _query_lock = lock; }
+
     private:
         std::unique_ptr<InterestingTransitionVisitor> _interesting;
+        std::mutex* _query_lock = nullptr;
 
         bool _closure;
     };
@@ -19,6 +19,7 @@
 #define VERIFYPN_STUBBORNSET_H
 
 #include "PetriEngine/PetriNet.h"
+#include "PetriEngine/IncrementalEnabledSet.h"
 #include "PetriEngine/Structures/State.h"
 #include "PetriEngine/Structures/light_deque.h"
 #include "PetriEngine/PQL/PQL.h"
@@ -98,6 +99,12 @@ namespace PetriEngine {
 
         [[nodiscard]] size_t nenabled() const { return _nenabled; }
 
+        // derive the enabled transitions from those of the previously prepared marking
+        void setIncremental(bool incremental) {
+            if (!incremental) _incremental = nullptr;
+            else if (!_incremental) _incremental = std::make_unique<IncrementalEnabledSet>(_net);
+        }
+
         [[nodiscard]] bool *enabled() const { return _enabled.get(); };
         [[nodiscard]] bool *stubborn() const { return _stubborn.get(); };
 
@@ -137,10 +144,22 @@ namespace PetriEngine {
 
         bool checkPreset(uint32_t t);
 
+        template <bool Inhibitors>
+        bool checkPresetImpl(uint32_t t);
+
+        template <bool Inhibitors>
+        void addEnabled();
+
         virtual void addToStub(uint32_t t);
 
         template <typename T = std::nullptr_t>
         void closure(T callback = nullptr) {
+            if (_netContainsInhibitorArcs) closureImpl<true>(callback);
+            else closureImpl<false>(callback);
+        }
+
+        template <bool Inhibitors, typename T>
+        void closureImpl(T callback) {
             while (!_unprocessed.empty()) {
                 if constexpr (!std::is_null_pointer_v<T>) {
                     if (!callback()) return;
@@ -158,7 +177,7 @@ namespace PetriEngine {
                                 addToStub(_transitions.get()[t].index);
                         }
                     }
-                    if (_netContainsInhibitorArcs) {
+                    if constexpr (Inhibitors) {
                         uint32_t next_finv = transitions()[tr + 1].inputs;
                         for (; linv < next_finv; linv++) {
                             if (invariants()[linv].direction > 0)
@@ -178,7 +197,7 @@ namespace PetriEngine {
                             inhib = false;
                             ok = (_places_seen.get()[inv.place] & 1) != 0;
                             cand = inv.place;
-                        } else if ((*_parent).marking()[inv.place] >= inv.tokens && inv.inhibitor) {
+                        } else if (Inhibitors && (*_parent).marking()[inv.place] >= inv.tokens && inv.inhibitor) {
                             inhib = true;
                             ok = (_places_seen.get()[inv.place] & 2) != 0;
                             cand = inv.place;
@@ -207,6 +226,7 @@ namespace PetriEngine {
         std::unique_ptr<uint32_t[]> _dependency;
         bool _netContainsInhibitorArcs, _done;
         std::vector<std::vector<uint32_t>> _inhibpost;
+        std::unique_ptr<IncrementalEnabledSet> _incremental;
 
         std::vector<PQL::Condition *> _queries;
 
@@ -18,6 +18,7 @@
 #include "Structures/State.h"
 #include <memory>
 #include "Stubborn/StubbornSet.h"
+#include "IncrementalEnabledSet.h"
 
 namespace PetriEngine {
 
@@ -43,6 +44,12 @@ public:
 
     void reset();
 
+    /**
+     * Derive the enabled transitions from those of the previously prepared
+     * marking instead of checking all candidates again
+     */
+    virtual void setIncremental(bool incremental);
+
     /**
      * Checks if the conditions are met for fireing t, if write != NULL,
      * then also consumes tokens from write while checking
@@ -78,7 +85,18 @@ protected:
     uint32_t _suc_pcounter;
     uint32_t _suc_tcounter;
 
+    std::unique_ptr<IncrementalEnabledSet> _incremental;
+
 private:
+    bool nextIncremental(Structures::State& write);
+
+    // the inhibitor checks are compiled out for nets without inhibitor arcs
+    template<bool Inhibitors>
+    bool nextImpl(Structures::State& write);
+    template<bool Inhibitors>
+    bool checkPresetImpl(uint32_t t);
+    template<bool Inhibitors>
+    void consumePresetImpl(Structures::State& write, uint32_t t);
 
     friend class ReducingSuccessorGenerator;
 
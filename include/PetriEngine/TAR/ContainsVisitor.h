@@ -177,6 +177,18 @@ namespace PetriEngine
         virtual void _accept(const AXCondition* el)
         {   handleSimpleQuantifierCondition(el); }
         
+        // A, E, F, G and X
+        virtual void _accept(const SimpleQuantifierCondition* el)
+        {   handleSimpleQuantifierCondition(el); }
+
+        virtual void _accept(const UntilCondition* el)
+        {   
+            if(found_type(el)) return;
+            (*el)[0]->visit(*this);
+            if(_value) return;
+            (*el)[1]->visit(*this);
+        }
+
         virtual void _accept(const EUCondition* el)
         {   
             if(found_type(el)) return;
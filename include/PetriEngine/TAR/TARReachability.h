@@ -26,6 +26,9 @@
 
 #include "PetriEngine/Reachability/ReachabilitySearch.h"
 
+#include <atomic>
+#include <mutex>
+
 
 namespace PetriEngine {
     namespace Reachability {
@@ -50,7 +53,14 @@ namespace PetriEngine {
                 std::vector<std::shared_ptr<PQL::Condition > >& queries,
                 std::vector<ResultPrinter::Result>& results,
                 bool printstats, bool printtrace);
+
+            // used when the queries are shared with searches running in other threads
+            void setQueryLock(std::mutex* lock) { _query_lock = lock; }
+
+            // the search gives up (without answering) once the flag is raised
+            void setStopFlag(const std::atomic<bool>* stop) { _stop = stop; }
         private:
+            bool stopped() const { return _stop != nullptr && _stop->load(std::memory_order_relaxed); }
 
             void printTrace(trace_t& stack);
             void nextEdge(AntiChain<uint32_t, size_t>& checked, state_t& state, trace_t& waiting, std::set<size_t>& nextinter);
@@ -73,6 +83,8 @@ namespace PetriEngine {
             PetriNet& _net;
             Reducer* _reducer;
             TraceSet _traceset;
+            std::mutex* _query_lock = nullptr;
+            const std::atomic<bool>* _stop = nullptr;
 
 #ifdef TAR_TIMING
             double _check_time = 0;
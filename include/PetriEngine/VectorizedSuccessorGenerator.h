@@ -0,0 +1,65 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef VECTORIZEDSUCCESSORGENERATOR_H
+#define VECTORIZEDSUCCESSORGENERATOR_H
+
+#include "SuccessorGenerator.h"
+
+#include <vector>
+
+namespace PetriEngine {
+
+    /**
+     * Successor generator checking the enabledness of blocks of eight
+     * transitions at a time. The presets are stored as a structure of arrays
+     * (place, tokens, inhibitor mask) per block, padded with arcs that are
+     * always satisfied. The block check uses AVX2 or SSE4.1 when the CPU
+     * supports it (decided at runtime) and a scalar loop otherwise.
+     * Successors are produced in the same order as by SuccessorGenerator.
+     */
+    class VectorizedSuccessorGenerator : public SuccessorGenerator {
+    public:
+        static constexpr uint32_t LANES = 8;
+
+        VectorizedSuccessorGenerator(const PetriNet& net);
+        VectorizedSuccessorGenerator(const PetriNet& net, std::vector<std::shared_ptr<PQL::Condition> >& queries);
+        VectorizedSuccessorGenerator(const PetriNet& net, const std::shared_ptr<PQL::Condition> &query);
+
+        bool prepare(const Structures::State* state) override;
+        bool next(Structures::State& write) override;
+
+        // every block is checked anyway, so there is nothing to gain
+        void setIncremental(bool) override {}
+
+        /** name of the block check selected for this CPU */
+        static const char* implementation();
+
+        using block_check_t = uint32_t (*)(const MarkVal* marking, const uint32_t* places,
+                                           const uint32_t* tokens, const uint32_t* inhibitor, uint32_t arcs);
+    private:
+        // arcs of block b are [_blockArcs[b], _blockArcs[b+1]) in units of LANES
+        std::vector<uint32_t> _blockArcs;
+        std::vector<uint32_t> _places;
+        std::vector<uint32_t> _tokens;
+        std::vector<uint32_t> _inhibitor;
+        // enabled transitions of each block, one bit per lane
+        std::vector<uint8_t> _enabled;
+        block_check_t _check;
+    };
+}
+
+#endif /* VECTORIZEDSUCCESSORGENERATOR_H */
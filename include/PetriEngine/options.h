@@ -67,6 +67,14 @@ struct options_t {
     uint32_t siphontrapTimeout = 0;
     uint32_t siphonDepth = 0;
     uint32_t cores = 1;
+    uint32_t bitstate = 0; // log2 of the bitstate table size in bits, 0 ... exact state storage
+    uint32_t bitstate_hashes = 3;
+    bool vectorized_successors = false;
+    bool incremental_enabled = false;
+    size_t beam_width = 10000;
+    size_t restart_interval = 1000;
+    std::string external_dir; // external-memory BFS when non-empty
+    size_t external_memory = 1024; // MB of successors buffered before they are written to disk
     std::string output_stats;
     bool doVerification = true;
 
@@ -76,6 +84,8 @@ struct options_t {
     bool gamemode = false;
     bool usedctl = false;
     CTL::CTLAlgorithmType ctlalgorithm = CTL::CZero;
+    size_t ctl_memory_limit = 0; // bytes of dependency graph before decided configurations are reclaimed, 0 is unbounded
+    uint32_t ctl_dfs_ratio = 0; // percentage of edges the CTL heuristic search takes depth-first
     bool tar = false;
     uint32_t binary_query_io = 0;
 
@@ -102,6 +112,7 @@ struct options_t {
     
     //CPN Specific options
     bool cpnOverApprox = false;
+    bool colored_search = false; // search the colored net without unfolding it
     bool computeCFP = true;
     bool computePartition = true;
     bool symmetricVariables = true;
@@ -126,6 +137,12 @@ struct options_t {
             optionsOut << "\nSearch=HEUR";
         } else if (strategy == PetriEngine::Reachability::Strategy::RDFS){
             optionsOut << "\nSearch=RDFS";
+        } else if (strategy == PetriEngine::Reachability::Strategy::ASTAR){
+            optionsOut << "\nSearch=AStar";
+        } else if (strategy == PetriEngine::Reachability::Strategy::BEAM){
+            optionsOut << "\nSearch=Beam(" << beam_width << ")";
+        } else if (strategy == PetriEngine::Reachability::Strategy::RESTART){
+            optionsOut << "\nSearch=RestartBestFS(" << restart_interval << ")";
         } else {
             optionsOut << "\nSearch=OverApprox";
         }
@@ -140,6 +157,10 @@ struct options_t {
             optionsOut << ",Token_Bound=" << kbound;
         }
         
+        if (bitstate > 0) {
+            optionsOut << ",Bitstate=" << bitstate << "x" << bitstate_hashes;
+        }
+        
         if (statespaceexploration) {
             optionsOut << ",State_Space_Exploration=ENABLED";
         } else {
@@ -1,9 +1,21 @@
 #!/bin/bash
 
+# Runs every query of every model in D (default test_models) and writes the
+# answers to F. If a reference binary R or reference options RO are given, each
+# query is also run by R (default B) with RO (default O), and the script exits
+# with 1 if any answer differs from the reference. E.g. to compare the
+# multi-core nested DFS with Tarjan:
+#   ./run_tests.sh verifypn "-ltl ndfs -z 4" out 5 test_models/LTL "" "-ltl tarjan"
+# or the search of colored nets with the search of their unfolding:
+#   ./run_tests.sh verifypn "--colored-search" out 5 test_models/Colored "" "-r 0"
+
 B=$1
 O=$2
 F=$3
 T="$4"
+D=$5
+R=$6
+RO="$7"
 
 if [ -z "$B" ] ; then
 	echo "Missing binary"
@@ -23,18 +35,44 @@ if [ -z "$T" ] ; then
 	T=5
 fi
 
+if [ -z "$D" ] ; then
+	D=test_models
+fi
+COMPARE=0
+if [ ! -z "$R" ] || [ ! -z "$RO" ] ; then
+	COMPARE=1
+fi
+if [ -z "$R" ] ; then
+	R=$B
+fi
+if [ -z "$RO" ] ; then
+	RO=$O
+fi
+
 
 
 
 echo "" > $F
-for f in $(ls test_models) ; do
+FAILED=0
+for f in $(ls $D) ; do
+	if [ ! -f "$D/$f/model.pnml" ] || [ ! -f "$D/$f/query.xml" ] ; then
+		continue
+	fi
 	echo "Run $f" 
-	NP=$(grep "<property>" "test_models/$f/query.xml" | wc -l)
+	NP=$(grep "<property>" "$D/$f/query.xml" | wc -l)
 	for Q in $(seq 1 $NP ) ; do 
 		echo "	Q$Q"
-		res=$(eval "timeout $T $1 $2 -x $Q test_models/$f/model.pnml test_models/$f/query.xml " | grep "Query is ")
+		res=$(eval "timeout $T $B $O -x $Q $D/$f/model.pnml $D/$f/query.xml " | grep "Query is ")
 		if [ ! -z "$res" ] ; then
 			echo "$f:$Q:$res" >> $F
 		fi
+		if [ $COMPARE -eq 1 ] && [ ! -z "$res" ] ; then
+			ref=$(eval "timeout $T $R $RO -x $Q $D/$f/model.pnml $D/$f/query.xml " | grep "Query is ")
+			if [ ! -z "$ref" ] && [ "$res" != "$ref" ] ; then
+				echo "$f:$Q: $res, reference: $ref"
+				FAILED=1
+			fi
+		fi
 	done
 done
+exit $FAILED
@@ -0,0 +1,150 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures the ConcurrentStateSet on its own. The markings of a model are
+ * generated up front by a breadth first search, and for every given number
+ * of threads they are added to a fresh state set from that many threads.
+ * Only the inserts are timed, so successor generation, parsing and work
+ * distribution do not show up in the numbers.
+ *
+ * Usage: benchmark-stateset <model.pnml> <markings> <threads> [<threads> ...]
+ */
+
+#include "PetriParse/PNMLParser.h"
+#include "PetriEngine/Colored/ColoredPetriNetBuilder.h"
+#include "PetriEngine/PetriNetBuilder.h"
+#include "PetriEngine/SuccessorGenerator.h"
+#include "PetriEngine/Structures/ConcurrentStateSet.h"
+#include "PetriEngine/Structures/State.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace PetriEngine;
+using namespace PetriEngine::Structures;
+
+// breadth first search storing the first max markings of the net
+static std::vector<MarkVal> generateMarkings(const PetriNet& net, size_t max)
+{
+    const size_t nplaces = net.numberOfPlaces();
+    std::vector<MarkVal> markings;
+    ConcurrentStateSet states(net, 0, 1, 1);
+    SuccessorGenerator generator(net);
+    State state;
+    State working;
+    state.setMarking(net.makeInitialMarking());
+    working.setMarking(net.makeInitialMarking());
+
+    auto r = states.add(state, 0);
+    markings.insert(markings.end(), state.marking(), state.marking() + nplaces);
+    for(size_t next = 0; r.first && next < states.discovered() && markings.size() < max * nplaces; ++next)
+    {
+        states.decode(state, next, 0);
+        generator.prepare(&state);
+        while(generator.next(working) && markings.size() < max * nplaces)
+        {
+            if(!states.add(working, 0).first) continue;
+            markings.insert(markings.end(), working.marking(), working.marking() + nplaces);
+        }
+    }
+    return markings;
+}
+
+static double insertAll(const PetriNet& net, const std::vector<MarkVal>& markings, size_t nthreads)
+{
+    const size_t nplaces = net.numberOfPlaces();
+    const size_t count = markings.size() / nplaces;
+    ConcurrentStateSet states(net, 0, nthreads * 4, nthreads);
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::high_resolution_clock::now();
+    for(size_t t = 0; t < nthreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            State state;
+            state.setMarking(new MarkVal[nplaces]);
+            for(size_t i = t; i < count; i += nthreads)
+            {
+                memcpy(state.marking(), markings.data() + i * nplaces, sizeof(MarkVal) * nplaces);
+                states.add(state, t);
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    if(states.discovered() != count)
+    {
+        fprintf(stderr, "Error: %zu markings were added, but the state set holds %zu\n", count, states.discovered());
+        exit(1);
+    }
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 4)
+    {
+        fprintf(stderr, "Usage: %s <model.pnml> <markings> <threads> [<threads> ...]\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream mfile(argv[1], std::ifstream::in);
+    if(!mfile)
+    {
+        fprintf(stderr, "Error: Model file \"%s\" couldn't be opened\n", argv[1]);
+        return 1;
+    }
+    ColoredPetriNetBuilder cpnBuilder;
+    PNMLParser parser;
+    parser.parse(mfile, &cpnBuilder);
+    mfile.close();
+
+    auto& builder = cpnBuilder.unfold();
+    builder.sort();
+    std::unique_ptr<PetriNet> net(builder.makePetriNet());
+    if(net->numberOfPlaces() == 0)
+    {
+        fprintf(stderr, "Error: The net has no places\n");
+        return 1;
+    }
+
+    auto markings = generateMarkings(*net, std::strtoull(argv[2], nullptr, 10));
+    const size_t count = markings.size() / net->numberOfPlaces();
+
+    printf("threads,markings,seconds,inserts/s\n");
+    for(int i = 3; i < argc; ++i)
+    {
+        size_t nthreads = std::strtoull(argv[i], nullptr, 10);
+        if(nthreads == 0)
+        {
+            fprintf(stderr, "Error: \"%s\" is not a number of threads\n", argv[i]);
+            return 1;
+        }
+        double seconds = insertAll(*net, markings, nthreads);
+        printf("%zu,%zu,%f,%.0f\n", nthreads, count, seconds, seconds > 0 ? count / seconds : 0.0);
+    }
+    return 0;
+}
@@ -74,28 +74,23 @@ void Algorithm::CertainZeroFPA::checkEdge(Edge* e, bool only_assign)
     Configuration *lastUndecided = nullptr;
     {
         auto it = e->targets.begin();
-        auto pit = e->targets.before_begin();
         while(it != e->targets.end())
         {
             if ((*it)->assignment == ONE)
             {
-                e->targets.erase_after(pit);
-                it = pit;
+                it = e->targets.erase(it);
+                continue;
             }
-            else
+            allOne = false;
+            if ((*it)->assignment == CZERO) {
+                hasCZero = true;
+                //assert(e->assignment == CZERO || only_assign);
+                break;
+            }
+            else if(lastUndecided == nullptr)
             {
-                allOne = false;
-                if ((*it)->assignment == CZERO) {
-                    hasCZero = true;
-                    //assert(e->assignment == CZERO || only_assign);
-                    break;
-                }
-                else if(lastUndecided == nullptr)
-                {
-                    lastUndecided = *it;
-                }
+                lastUndecided = *it;
             }
-            pit = it;
             ++it;
         }
     }
@@ -206,6 +201,7 @@ void Algorithm::CertainZeroFPA::finalAssign(DependencyGraph::Configuration *c, D
     }
     
     c->dependency_set.clear();
+    c->dependency_set.shrink_to_fit();
 }
 
 void Algorithm::CertainZeroFPA::explore(Configuration *c)
@@ -213,7 +209,10 @@ void Algorithm::CertainZeroFPA::explore(Configuration *c)
     c->assignment = ZERO;
 
     {
-        auto succs = graph->successors(c);
+        // checkEdge does not explore when only assigning, so the buffer is
+        // not reused before we are done with it
+        auto& succs = _succs;
+        graph->successors(c, succs);
         c->nsuccs = succs.size();
 
         _exploredConfigurations += 1;
@@ -5,7 +5,7 @@
 #include "CTL/SearchStrategy/HeuristicSearch.h"
 
 namespace Algorithm {
-    FixedPointAlgorithm::FixedPointAlgorithm(PetriEngine::Reachability::Strategy type) {
+    FixedPointAlgorithm::FixedPointAlgorithm(PetriEngine::Reachability::Strategy type, uint32_t dfs_ratio) {
         using namespace PetriEngine::Reachability;
         using namespace SearchStrategy;
         switch(type)
@@ -20,7 +20,7 @@ namespace Algorithm {
                 strategy = std::make_shared<BFSSearch>();
                 break;
             case HEUR:
-                strategy = std::make_shared<HeuristicSearch>();
+                strategy = std::make_shared<HeuristicSearch>(dfs_ratio);
                 break;
             default:
                 std::cerr << "Search strategy is unsupported by the CTL-Engine"   <<  std::endl;
@@ -89,13 +89,15 @@ void Algorithm::LocalFPA::finalAssign(DependencyGraph::Configuration *c, Depende
     }
 
     c->dependency_set.clear();
+    c->dependency_set.shrink_to_fit();
 }
 
 void Algorithm::LocalFPA::explore(DependencyGraph::Configuration *c)
 {
     assert(c->assignment == DependencyGraph::UNKNOWN);
     c->assignment = DependencyGraph::ZERO;
-    auto succs = graph->successors(c);
+    auto& succs = _succs;
+    graph->successors(c, succs);
 
     for (DependencyGraph::Edge *succ : succs) {
         strategy->pushEdge(succ);
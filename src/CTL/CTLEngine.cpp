@@ -13,9 +13,16 @@
 #include "PetriEngine/Reachability/ReachabilityResult.h"
 #include "PetriEngine/TAR/TARReachability.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
+#include <sstream>
 #include <vector>
+#ifdef VERIFYPN_MC_Simplification
+#include <thread>
+#endif
 #include <PetriEngine/PQL/Expressions.h>
 
 using namespace CTL;
@@ -25,15 +32,16 @@ using namespace PetriEngine::Reachability;
 using namespace PetriNets;
 
 ReturnValue getAlgorithm(std::shared_ptr<Algorithm::FixedPointAlgorithm>& algorithm,
-                         CTLAlgorithmType algorithmtype, Reachability::Strategy search)
+                         CTLAlgorithmType algorithmtype, Reachability::Strategy search,
+                         uint32_t dfs_ratio = 0)
 {
     switch(algorithmtype)
     {
         case CTLAlgorithmType::Local:
-            algorithm = std::make_shared<Algorithm::LocalFPA>(search);
+            algorithm = std::make_shared<Algorithm::LocalFPA>(search, dfs_ratio);
             break;
         case CTLAlgorithmType::CZero:
-            algorithm = std::make_shared<Algorithm::CertainZeroFPA>(search);
+            algorithm = std::make_shared<Algorithm::CertainZeroFPA>(search, dfs_ratio);
             break;
         default:
             cerr << "Error: Unknown or unsupported algorithm" << endl;
@@ -42,13 +50,13 @@ ReturnValue getAlgorithm(std::shared_ptr<Algorithm::FixedPointAlgorithm>& algori
     return ContinueCode;
 }
 
-void printResult(const std::string& qname, CTLResult& result, bool statisticslevel, bool mccouput, bool only_stats, size_t index, options_t& options){
+void printResult(std::ostream& out, const std::string& qname, CTLResult& result, bool statisticslevel, bool mccouput, bool only_stats, size_t index, options_t& options){
     const static string techniques = "TECHNIQUES COLLATERAL_PROCESSING EXPLICIT STATE_COMPRESSION SAT_SMT ";
 
     if(!only_stats)
     {
-        cout << endl;
-        cout << "FORMULA "
+        out << endl;
+        out << "FORMULA "
              << qname
              << " " << (result.result ? "TRUE" : "FALSE") << " "
              << techniques
@@ -57,32 +65,43 @@ void printResult(const std::string& qname, CTLResult& result, bool statisticslev
              << (options.ctlalgorithm == CTL::CZero ? "CTL_CZERO " : "")
              << (options.ctlalgorithm == CTL::Local ? "CTL_LOCAL " : "")
                 << endl << endl;
-        std::cout << "Query index " << index << " was solved" << std::endl;
-        cout << "Query is" << (result.result ? "" : " NOT") << " satisfied." << endl;
+        out << "Query index " << index << " was solved" << std::endl;
+        out << "Query is" << (result.result ? "" : " NOT") << " satisfied." << endl;
 
-        cout << endl;
+        out << endl;
     }
     if(statisticslevel){
-        cout << "STATS:" << endl;
-        cout << "	Time (seconds)    : " << setprecision(4) << result.duration / 1000 << endl;
-        cout << "	Configurations    : " << result.numberOfConfigurations << endl;
-        cout << "	Markings          : " << result.numberOfMarkings << endl;
-        cout << "	Edges             : " << result.numberOfEdges << endl;
-        cout << "	Processed Edges   : " << result.processedEdges << endl;
-        cout << "	Processed N. Edges: " << result.processedNegationEdges << endl;
-        cout << "	Explored Configs  : " << result.exploredConfigurations << endl;
-        std::cout << endl;
+        out << "STATS:" << endl;
+        out << "	Time (seconds)    : " << setprecision(4) << result.duration / 1000 << endl;
+        out << "	Configurations    : " << result.numberOfConfigurations << endl;
+        out << "	Markings          : " << result.numberOfMarkings << endl;
+        out << "	Reused Markings   : " << result.reusedMarkings;
+        if(result.numberOfMarkings > 0)
+            out << " (" << setprecision(4) << (100.0 * result.reusedMarkings / result.numberOfMarkings) << "%)";
+        out << endl;
+        out << "	Edges             : " << result.numberOfEdges << endl;
+        out << "	Processed Edges   : " << result.processedEdges << endl;
+        out << "	Processed N. Edges: " << result.processedNegationEdges << endl;
+        out << "	Explored Configs  : " << result.exploredConfigurations << endl;
+        if(options.ctl_memory_limit != 0)
+            out << "	Reclaimed Configs : " << result.reclaimedConfigurations << endl;
+        out << "	Explored Configs/s: " << setprecision(6)
+            << (result.duration > 0 ? result.exploredConfigurations / (result.duration / 1000) : 0) << endl;
+        out << endl;
     }
 }
 
 bool singleSolve(const Condition_ptr& query, PetriNet* net,
                  CTLAlgorithmType algorithmtype,
-                 Strategy strategytype, bool partial_order, CTLResult& result)
+                 Strategy strategytype, bool partial_order, CTLResult& result, options_t& options,
+                 const std::shared_ptr<MarkingStore>& store)
 {
-    OnTheFlyDG graph(net, partial_order);
+    OnTheFlyDG graph(net, partial_order, store);
+    graph.setMemoryLimit(options.ctl_memory_limit);
+    graph.setDistances(strategytype == HEUR);
     graph.setQuery(query);
     std::shared_ptr<Algorithm::FixedPointAlgorithm> alg = nullptr;
-    if(getAlgorithm(alg, algorithmtype,  strategytype) == ErrorCode)
+    if(getAlgorithm(alg, algorithmtype,  strategytype, options.ctl_dfs_ratio) == ErrorCode)
     {
         assert(false);
         throw std::exception();
@@ -100,12 +119,15 @@ bool singleSolve(const Condition_ptr& query, PetriNet* net,
     result.processedNegationEdges += alg->processedNegationEdges();
     result.exploredConfigurations += alg->exploredConfigurations();
     result.numberOfEdges += alg->numberOfEdges();
+    result.reclaimedConfigurations += graph.reclaimedCount();
+    result.reusedMarkings += graph.reusedMarkingCount();
     return res;
 }
 
 bool recursiveSolve(const Condition_ptr& query, PetriNet* net,
                     CTLAlgorithmType algorithmtype,
-                    Strategy strategytype, bool partial_order, CTLResult& result, options_t& options);
+                    Strategy strategytype, bool partial_order, CTLResult& result, options_t& options,
+                    const std::shared_ptr<MarkingStore>& store);
 
 class ResultHandler : public AbstractHandler {
     private:
@@ -142,7 +164,8 @@ class ResultHandler : public AbstractHandler {
 
 bool solveLogicalCondition(LogicalCondition* query, bool is_conj, PetriNet* net,
                            CTLAlgorithmType algorithmtype,
-                           Reachability::Strategy strategytype, bool partial_order, CTLResult& result, options_t& options)
+                           Reachability::Strategy strategytype, bool partial_order, CTLResult& result, options_t& options,
+                           const std::shared_ptr<MarkingStore>& store)
 {
     std::vector<int8_t> state(query->size(), 0);
     std::vector<int8_t> lstate;
@@ -197,7 +220,7 @@ bool solveLogicalCondition(LogicalCondition* query, bool is_conj, PetriNet* net,
     for(size_t i = 0; i < query->size(); ++i) {
         if (state[i] == 0)
         {
-            if(recursiveSolve((*query)[i], net, algorithmtype, strategytype, partial_order, result, options) xor is_conj)
+            if(recursiveSolve((*query)[i], net, algorithmtype, strategytype, partial_order, result, options, store) xor is_conj)
             {
                 return !is_conj;
             }
@@ -225,19 +248,20 @@ public:
 
 bool recursiveSolve(const Condition_ptr& query, PetriEngine::PetriNet* net,
                     CTL::CTLAlgorithmType algorithmtype,
-                    PetriEngine::Reachability::Strategy strategytype, bool partial_order, CTLResult& result, options_t& options)
+                    PetriEngine::Reachability::Strategy strategytype, bool partial_order, CTLResult& result, options_t& options,
+                    const std::shared_ptr<MarkingStore>& store)
 {
     if(auto q = dynamic_cast<NotCondition*>(query.get()))
     {
-        return ! recursiveSolve((*q)[0], net, algorithmtype, strategytype, partial_order, result, options);
+        return ! recursiveSolve((*q)[0], net, algorithmtype, strategytype, partial_order, result, options, store);
     }
     else if(auto q = dynamic_cast<AndCondition*>(query.get()))
     {
-        return solveLogicalCondition(q, true, net, algorithmtype, strategytype, partial_order, result, options);
+        return solveLogicalCondition(q, true, net, algorithmtype, strategytype, partial_order, result, options, store);
     }
     else if(auto q = dynamic_cast<OrCondition*>(query.get()))
     {
-        return solveLogicalCondition(q, false, net, algorithmtype, strategytype, partial_order, result, options);
+        return solveLogicalCondition(q, false, net, algorithmtype, strategytype, partial_order, result, options, store);
     }
     else if(query->isReachability())
     {
@@ -265,11 +289,57 @@ bool recursiveSolve(const Condition_ptr& query, PetriEngine::PetriNet* net,
     }
     else
     {
-        return singleSolve(query, net, algorithmtype, strategytype, partial_order, result);
+        return singleSolve(query, net, algorithmtype, strategytype, partial_order, result, options, store);
     }
 }
 
 
+void solveCTL(std::ostream& out, PetriNet* net,
+              CTLAlgorithmType algorithmtype,
+              Strategy strategytype,
+              bool printstatistics,
+              bool mccoutput,
+              bool partial_order,
+              const std::string& queryname,
+              const Condition_ptr& query,
+              size_t qnum,
+              options_t& options,
+              const std::shared_ptr<MarkingStore>& store)
+{
+    CTLResult result(query);
+    bool solved = false;
+
+    {
+        OnTheFlyDG graph(net, partial_order);
+        graph.setQuery(result.query);
+        switch (graph.initialEval()) {
+            case Condition::Result::RFALSE:
+                result.result = false;
+                solved = true;
+                break;
+            case Condition::Result::RTRUE:
+                result.result = true;
+                solved = true;
+                break;
+            default:
+                break;
+        }
+    }
+    result.numberOfConfigurations = 0;
+    result.numberOfMarkings = 0;
+    result.processedEdges = 0;
+    result.processedNegationEdges = 0;
+    result.exploredConfigurations = 0;
+    result.numberOfEdges = 0;
+    result.reusedMarkings = 0;
+    result.duration = 0;
+    if(!solved)
+    {
+        result.result = recursiveSolve(result.query, net, algorithmtype, strategytype, partial_order, result, options, store);
+    }
+    printResult(out, queryname, result, printstatistics, mccoutput, false, qnum, options);
+}
+
 ReturnValue CTLMain(PetriNet* net,
                     CTLAlgorithmType algorithmtype,
                     Strategy strategytype,
@@ -283,39 +353,48 @@ ReturnValue CTLMain(PetriNet* net,
                     options_t& options
         )
 {
-    for(auto qnum : querynumbers){
-        CTLResult result(queries[qnum]);
-        bool solved = false;
-
-        {
-            OnTheFlyDG graph(net, partial_order);
-            graph.setQuery(result.query);
-            switch (graph.initialEval()) {
-                case Condition::Result::RFALSE:
-                    result.result = false;
-                    solved = true;
-                    break;
-                case Condition::Result::RTRUE:
-                    result.result = true;
-                    solved = true;
-                    break;
-                default:
-                    break;
-            }
-        }
-        result.numberOfConfigurations = 0;
-        result.numberOfMarkings = 0;
-        result.processedEdges = 0;
-        result.processedNegationEdges = 0;
-        result.exploredConfigurations = 0;
-        result.numberOfEdges = 0;
-        result.duration = 0;
-        if(!solved)
+#ifdef VERIFYPN_MC_Simplification
+    // the queries only share the (read-only) net, so they can be solved independently.
+    // Results are buffered and printed whenever a query completes.
+    size_t nthreads = std::min<size_t>(options.cores, querynumbers.size());
+    if(nthreads > 1)
+    {
+        std::atomic<size_t> next(0);
+        std::mutex out_lock;
+        std::vector<std::thread> threads;
+        for(size_t t = 0; t < nthreads; ++t)
         {
-            result.result = recursiveSolve(result.query, net, algorithmtype, strategytype, partial_order, result, options);
+            threads.emplace_back([&]() {
+                // options are copied as the seed is advanced by the searches
+                options_t local = options;
+                if(options.ctl_memory_limit != 0)
+                    local.ctl_memory_limit = std::max<size_t>(1, options.ctl_memory_limit / nthreads);
+                // the queries solved by this thread share their markings,
+                // unless the memory is bounded as a store is never pruned
+                auto store = options.ctl_memory_limit == 0 ? std::make_shared<MarkingStore>() : nullptr;
+                while(true)
+                {
+                    auto i = next++;
+                    if(i >= querynumbers.size()) return;
+                    auto qnum = querynumbers[i];
+                    std::stringstream ss;
+                    solveCTL(ss, net, algorithmtype, strategytype, printstatistics, mccoutput,
+                             partial_order, querynames[qnum], queries[qnum], qnum, local, store);
+                    std::lock_guard<std::mutex> lock(out_lock);
+                    std::cout << ss.str() << std::flush;
+                }
+            });
         }
-        printResult(querynames[qnum], result, printstatistics, mccoutput, false, qnum, options);
+        for(auto& t : threads)
+            t.join();
+        return SuccessCode;
+    }
+#endif
+    // the queries are on the same net, so later queries reuse the markings of earlier ones
+    auto store = options.ctl_memory_limit == 0 ? std::make_shared<MarkingStore>() : nullptr;
+    for(auto qnum : querynumbers){
+        solveCTL(std::cout, net, algorithmtype, strategytype, printstatistics, mccoutput,
+                 partial_order, querynames[qnum], queries[qnum], qnum, options, store);
     }
     return SuccessCode;
 }
-
@@ -17,10 +17,12 @@ using namespace DependencyGraph;
 
 namespace PetriNets {
 
-OnTheFlyDG::OnTheFlyDG(PetriEngine::PetriNet *t_net, bool partial_order) : encoder(t_net->numberOfPlaces(), 0), 
+OnTheFlyDG::OnTheFlyDG(PetriEngine::PetriNet *t_net, bool partial_order, std::shared_ptr<MarkingStore> store)
+        : encoder(t_net->numberOfPlaces(), 0), 
+        _store(store ? store : std::make_shared<MarkingStore>()),
         edge_alloc(new linked_bucket_t<DependencyGraph::Edge,1024*10>(1)), 
         conf_alloc(new linked_bucket_t<char[sizeof(PetriConfig)], 1024*1024>(1)),
-        _redgen(*t_net, std::make_shared<PetriEngine::ReachabilityStubbornSet>(*t_net)), _partial_order(partial_order) {
+        _redgen(*t_net, std::make_shared<PetriEngine::ReachabilityStubbornSet>(*t_net)), _gen(*t_net), _partial_order(partial_order) {
     net = t_net;
     n_places = t_net->numberOfPlaces();
     n_transitions = t_net->numberOfTransitions();
@@ -55,14 +57,37 @@ Condition::Result OnTheFlyDG::fastEval(Condition* query, Marking* unfolded)
 }
 
 
-std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
+template<typename Pre, typename Foreach, typename Post>
+void OnTheFlyDG::nextStates(Marking& t_marking, Condition* ptr,
+    Pre&& pre, Foreach&& foreach, Post&& post)
+{
+    bool first = true;
+    memcpy(working_marking.marking(), query_marking.marking(), n_places*sizeof(PetriEngine::MarkVal));    
+    auto qf = static_cast<QuantifierCondition*>(ptr);
+    if(!_partial_order || ptr->getQuantifier() != E || ptr->getPath() != F || (*qf)[0]->isTemporal())
+    {
+        dowork(_gen, first, pre, foreach);
+    }
+    else
+    {
+        _redgen.setQuery(ptr);
+        dowork(_redgen, first, pre, foreach);
+    }
+
+    if(!first) post();
+}
+
+void OnTheFlyDG::successors(Configuration *c, std::vector<Edge*>& succs)
 {
     PetriEngine::PQL::DistanceContext context(net, query_marking.marking());
     PetriConfig *v = static_cast<PetriConfig*>(c);
-    trie.unpack(v->marking, encoder.scratchpad().raw());
+    _store->unpack(_markings[v->marking], encoder.scratchpad().raw());
     encoder.decode(query_marking.marking(), encoder.scratchpad().raw());
     //    v->printConfiguration();
-    std::vector<Edge*> succs;
+    succs.clear();
+    // v is being explored, so it is not reclaimed
+    if(_memoryLimit != 0 && memoryUsage() > _gcThreshold)
+        collectGarbage();
     auto query_type = v->query->getQueryType();
     if(query_type == EVAL){
         assert(false);
@@ -76,7 +101,7 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             // no need to try to evaluate here -- this is already transient in other evaluations.
             auto cond = static_cast<NotCondition*>(v->query);
             Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[0]);
-            Edge* e = newEdge(*v, /*v->query->distance(context)*/0);
+            Edge* e = newEdge(*v, edgeWeight(v->query, context));
             e->is_negated = true;
             e->addTarget(c);
             succs.push_back(e);
@@ -84,13 +109,14 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
         else if(v->query->getQuantifier() == AND){
             auto cond = static_cast<AndCondition*>(v->query);
             //Check if left is false
-            std::vector<Condition*> conds;
+            auto& conds = _conds;
+            conds.clear();
             for(auto& c : *cond)
             {
                 auto res = fastEval(c.get(), &query_marking);
                 if(res == Condition::RFALSE)
                 {
-                    return succs;
+                    return;
                 }
                 if(res == Condition::RUNKNOWN)
                 {
@@ -98,29 +124,31 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                 }
             }
             
-            Edge *e = newEdge(*v, /*cond->distance(context)*/0);
+            Edge *e = newEdge(*v, edgeWeight(cond, context));
 
             //If we get here, then either both propositions are true (shouldn't be possible)
             //Or a temporal operator and a true proposition
             //Or both are temporal
-            for(auto c : conds)
+            // the last conjunct is checked first
+            for(auto it = conds.rbegin(); it != conds.rend(); ++it)
             {
-                assert(c->isTemporal());
-                e->addTarget(createConfiguration(v->marking, v->getOwner(), c));
+                assert((*it)->isTemporal());
+                e->addTarget(createConfiguration(v->marking, v->getOwner(), *it));
             }
             succs.push_back(e);
         }
         else if(v->query->getQuantifier() == OR){
             auto cond = static_cast<OrCondition*>(v->query);
             //Check if left is true
-            std::vector<Condition*> conds;
+            auto& conds = _conds;
+            conds.clear();
             for(auto& c : *cond)
             {
                 auto res = fastEval(c.get(), &query_marking);
                 if(res == Condition::RTRUE)
                 {
                     succs.push_back(newEdge(*v, 0));
-                    return succs;
+                    return;
                 }
                 if(res == Condition::RUNKNOWN)
                 {
@@ -134,7 +162,7 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             for(auto c : conds)
             {
                 assert(c->isTemporal());
-                Edge *e = newEdge(*v, /*cond->distance(context)*/0);
+                Edge *e = newEdge(*v, edgeWeight(c, context));
                 e->addTarget(createConfiguration(v->marking, v->getOwner(), c));
                 succs.push_back(e);
             }
@@ -153,13 +181,13 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                     //right side is not temporal, eval it right now!
                     if (r1 == Condition::RTRUE) {    //satisfied, no need to go through successors
                         succs.push_back(newEdge(*v, 0));
-                        return succs;
+                        return;
                     }//else: It's not valid, no need to add any edge, just add successors
                 }
                 else {
                     //right side is temporal, we need to evaluate it as normal
                     Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[1]);
-                    right = newEdge(*v, /*(*cond)[1]->distance(context)*/0);
+                    right = newEdge(*v, edgeWeight((*cond)[1], context));
                     right->addTarget(c);
                 }
                 bool valid = false;
@@ -176,7 +204,13 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                     //if left side is guaranteed to be not satisfied, skip successor generation
                     Edge* leftEdge = NULL;
                     nextStates (query_marking, cond,
-                                [&](){ leftEdge = newEdge(*v, std::numeric_limits<uint32_t>::max());},
+                                [&](){
+                                    leftEdge = newEdge(*v, std::numeric_limits<uint32_t>::max());
+                                    // checked before the successors
+                                    if (left != NULL) {
+                                        leftEdge->addTarget(left);
+                                    }
+                                },
                                 [&](Marking& mark){
                                     auto res = fastEval(cond, &mark);
                                     if(res == Condition::RTRUE) return true;
@@ -196,9 +230,6 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                                 {
                                     if(leftEdge)
                                     {
-                                        if (left != NULL) {
-                                            leftEdge->addTarget(left);
-                                        }
                                         succs.push_back(leftEdge);                                    
                                     }
                                 }
@@ -217,10 +248,10 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                     bool valid = r == Condition::RTRUE;
                     if (valid) {
                         succs.push_back(newEdge(*v, 0));
-                        return succs;
+                        return;
                     }
                 } else {
-                    subquery = newEdge(*v, /*cond->distance(context)*/0);
+                    subquery = newEdge(*v, edgeWeight((*cond)[0], context));
                     Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[0]);
                     subquery->addTarget(c);
                 }
@@ -309,13 +340,13 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                 auto r1 = fastEval((*cond)[1], &query_marking);
                 if (r1 == Condition::RUNKNOWN) {
                     Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[1]);
-                    right = newEdge(*v, /*(*cond)[1]->distance(context)*/0);
+                    right = newEdge(*v, edgeWeight((*cond)[1], context));
                     right->addTarget(c);
                 } else {
                     bool valid = r1 == Condition::RTRUE;
                     if (valid) {
                         succs.push_back(newEdge(*v, 0));
-                        return succs;
+                        return;
                     }   // else: right condition is not satisfied, no need to add an edge
                 }
 
@@ -355,12 +386,12 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                             return false;
                         }
                         context.setMarking(marking.marking());
-                        Edge* e = newEdge(*v, /*cond->distance(context)*/0);
+                        Edge* e = newEdge(*v, edgeWeight(cond, context));
                         Configuration* c1 = createConfiguration(createMarking(marking), owner(marking, cond), cond);
-                        e->addTarget(c1);
                         if (left != NULL) {
                             e->addTarget(left);
                         }
+                        e->addTarget(c1);
                         succs.push_back(e);
                         return true;
                 }, [](){});
@@ -377,11 +408,11 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                     bool valid = r == Condition::RTRUE;
                     if (valid) {
                         succs.push_back(newEdge(*v, 0));
-                        return succs;
+                        return;
                     }
                 } else {
                     Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[0]);
-                    subquery = newEdge(*v, /*cond->distance(context)*/0);
+                    subquery = newEdge(*v, edgeWeight((*cond)[0], context));
                     subquery->addTarget(c);
                 }
 
@@ -404,7 +435,7 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                                     return false;
                                 }
                                 context.setMarking(mark.marking());
-                                Edge* e = newEdge(*v, /*cond->distance(context)*/0);
+                                Edge* e = newEdge(*v, edgeWeight(cond, context));
                                 Configuration* c = createConfiguration(createMarking(mark), owner(mark, cond), cond);
                                 e->addTarget(c);
                                 succs.push_back(e);
@@ -434,7 +465,7 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                             else if(res == Condition::RUNKNOWN)
                             {
                                 context.setMarking(marking.marking());
-                                Edge* e = newEdge(*v, /*(*cond)[0]->distance(context)*/0);
+                                Edge* e = newEdge(*v, edgeWeight(query, context));
                                 Configuration* c = createConfiguration(createMarking(marking), v->getOwner(), query);
                                 e->addTarget(c);
                                 succs.push_back(e);
@@ -461,7 +492,6 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
     {
         ((PetriConfig*)succs[0]->targets[0])->setOwner(v->getOwner());
     }*/
-    return succs;
 }
 
 Configuration* OnTheFlyDG::initialConfiguration()
@@ -477,28 +507,6 @@ Configuration* OnTheFlyDG::initialConfiguration()
 }
 
 
-void OnTheFlyDG::nextStates(Marking& t_marking, Condition* ptr,
-    std::function<void ()> pre, 
-    std::function<bool (Marking&)> foreach, 
-    std::function<void ()> post)
-{
-    bool first = true;
-    memcpy(working_marking.marking(), query_marking.marking(), n_places*sizeof(PetriEngine::MarkVal));    
-    auto qf = static_cast<QuantifierCondition*>(ptr);
-    if(!_partial_order || ptr->getQuantifier() != E || ptr->getPath() != F || (*qf)[0]->isTemporal())
-    {
-        PetriEngine::SuccessorGenerator PNGen(*net);
-        dowork<PetriEngine::SuccessorGenerator>(PNGen, first, pre, foreach);
-    }
-    else
-    {
-        _redgen.setQuery(ptr);
-        dowork<PetriEngine::ReducingSuccessorGenerator>(_redgen, first, pre, foreach);
-    }
-
-    if(!first) post();
-}
-
 void OnTheFlyDG::cleanUp()
 {    
     while(!recycle.empty())
@@ -533,16 +541,25 @@ size_t OnTheFlyDG::markingCount() const
 
 PetriConfig *OnTheFlyDG::createConfiguration(size_t marking, size_t own, Condition* t_query)
 {
-    auto& configs = trie.get_data(marking);
+    auto& configs = _configs[marking];
     for(PetriConfig* c : configs){
         if(c->query == t_query)
             return c;
     }
 
     _configurationCount++;
-    size_t id = conf_alloc->next(0);
-    char* mem = (*conf_alloc)[id];
-    PetriConfig* newConfig = new (mem) PetriConfig();
+    PetriConfig* newConfig = nullptr;
+    if(!_freeConfigs.empty())
+    {
+        newConfig = _freeConfigs.back();
+        _freeConfigs.pop_back();
+    }
+    else
+    {
+        size_t id = conf_alloc->next(0);
+        char* mem = (*conf_alloc)[id];
+        newConfig = new (mem) PetriConfig();
+    }
     newConfig->marking = marking;
     newConfig->query = t_query;
     newConfig->setOwner(own);
@@ -562,12 +579,70 @@ size_t OnTheFlyDG::createMarking(Marking& t_marking){
     unsigned char type = encoder.getType(sum, active, allsame, val);
     size_t length = encoder.encode(t_marking.marking(), type);
     binarywrapper_t w = binarywrapper_t(encoder.scratchpad().raw(), length*8);
-    auto tit = trie.insert(w.raw(), w.size());
-    if(tit.first){
+    auto tit = _store->insert(w.raw(), w.size());
+    auto local = _local.emplace(tit.second, _markings.size());
+    if(local.second){
+        _markings.push_back(tit.second);
+        _configs.emplace_back();
         _markingCount++;
+        if(!tit.first) _reusedCount++;
+    }
+
+    return local.first->second;
+}
+
+size_t OnTheFlyDG::memoryUsage()
+{
+    // an estimate, the overflow of edge targets and dependency sets and the
+    // overhead of the trie are not counted. The markings of the store count in
+    // full, also those inserted by other graphs, as they are never freed.
+    size_t configs = conf_alloc->size() - _freeConfigs.size();
+    size_t edges = edge_alloc->size() - recycle.size();
+    // an entry of _local is about a node of three words
+    size_t markings = _markings.size() * (4 * sizeof(size_t) + sizeof(std::vector<PetriConfig*>));
+    return configs * (sizeof(PetriConfig) + sizeof(PetriConfig*)) +
+           edges * sizeof(Edge) + markings + _store->bytes();
+}
+
+void OnTheFlyDG::collectGarbage()
+{
+    // released edges have a refcnt of -1, all other edges may still be
+    // processed and keep their source and targets alive
+    size_t nedges = edge_alloc->size();
+    for(size_t i = 0; i < nedges; ++i)
+    {
+        Edge* e = &(*edge_alloc)[i];
+        if(e->refcnt < 0) continue;
+        if(e->source) e->source->gc_mark = true;
+        for(auto t : e->targets) t->gc_mark = true;
     }
 
-    return tit.second;
+    size_t nconfs = conf_alloc->size();
+    for(size_t i = 0; i < nconfs; ++i)
+    {
+        PetriConfig* c = (PetriConfig*)&(*conf_alloc)[i];
+        if(c->query == nullptr) continue; // already reclaimed
+        if(c->gc_mark)
+        {
+            c->gc_mark = false;
+            continue;
+        }
+        if(!c->isDone() || c == initial_config || !c->dependency_set.empty())
+            continue;
+        // the configuration is created again (and recomputed) if it is reached later
+        auto& configs = _configs[c->marking];
+        auto it = std::find(configs.begin(), configs.end(), c);
+        assert(it != configs.end());
+        *it = configs.back();
+        configs.pop_back();
+        if(configs.empty()) configs.shrink_to_fit();
+        c->~PetriConfig();
+        _freeConfigs.push_back(new (c) PetriConfig());
+        ++_reclaimedCount;
+    }
+    // do not collect again before the graph has grown considerably
+    auto usage = memoryUsage();
+    _gcThreshold = std::max(_memoryLimit, usage + usage / 2);
 }
 
 void OnTheFlyDG::release(Edge* e)
@@ -588,6 +663,11 @@ size_t OnTheFlyDG::owner(Marking& marking, Condition* cond) {
 }
 
 
+uint32_t OnTheFlyDG::edgeWeight(Condition* cond, PetriEngine::PQL::DistanceContext& context)
+{
+    return _distances ? cond->distance(context) : 0;
+}
+
 Edge* OnTheFlyDG::newEdge(Configuration &t_source, uint32_t weight)
 {
     Edge* e = nullptr;
@@ -606,6 +686,7 @@ Edge* OnTheFlyDG::newEdge(Configuration &t_source, uint32_t weight)
     /*e->assignment = UNKNOWN;
     e->children = 0;*/
     e->source = &t_source;
+    e->weight = weight;
     assert(e->refcnt == 0);
     ++e->refcnt;
     return e;
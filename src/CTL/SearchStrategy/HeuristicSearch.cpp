@@ -9,22 +9,73 @@
 #include "CTL/DependencyGraph/Edge.h"
 #include "CTL/DependencyGraph/Configuration.h"
 
+#include <algorithm>
+
 namespace SearchStrategy {
 
+    // lowest weight at the top of the heap, newest first on ties
+    bool HeuristicSearch::heapOrder(const weighted_t& a, const weighted_t& b)
+    {
+        if(a.weight != b.weight) return a.weight > b.weight;
+        return a.slot < b.slot;
+    }
+
     size_t HeuristicSearch::Wsize() const {
-        return W.size();
+        return _live;
     }
 
     void HeuristicSearch::pushToW(DependencyGraph::Edge* edge) {
+        _heap.push_back({edge->weight, W.size(), edge});
+        std::push_heap(_heap.begin(), _heap.end(), heapOrder);
         W.push_back(edge);
+        ++_live;
     }
 
     DependencyGraph::Edge* HeuristicSearch::popFromW() {
-        auto it = std::max_element(W.begin(), W.end(), [](auto a, auto b){
-            return false; // a->targets.size() < b->targets.size();
-        });
-        auto edge = *it;
-        W.erase(it);
+        assert(_live > 0);
+        DependencyGraph::Edge* edge = nullptr;
+        _credit += _dfs_ratio;
+        if(_credit >= 100)
+        {
+            _credit -= 100;
+            while(W.back() == nullptr) W.pop_back();
+            edge = W.back();
+            W.pop_back();
+        }
+        else
+        {
+            // skip the entries of edges already taken depth-first; a slot
+            // can be reused by another push, so the edge is compared as well
+            while(true)
+            {
+                std::pop_heap(_heap.begin(), _heap.end(), heapOrder);
+                auto top = _heap.back();
+                _heap.pop_back();
+                if(top.slot < W.size() && W[top.slot] == top.edge && top.edge->weight == top.weight)
+                {
+                    edge = top.edge;
+                    W[top.slot] = nullptr;
+                    break;
+                }
+            }
+            while(!W.empty() && W.back() == nullptr) W.pop_back();
+        }
+        --_live;
+        if(W.size() > 2 * _live + 1024 || _heap.size() > 2 * _live + 1024)
+            compact();
         return edge;
-    }  
+    }
+
+    void HeuristicSearch::compact() {
+        _heap.clear();
+        size_t n = 0;
+        for(auto e : W)
+        {
+            if(e == nullptr) continue;
+            _heap.push_back({e->weight, n, e});
+            W[n++] = e;
+        }
+        W.resize(n);
+        std::make_heap(_heap.begin(), _heap.end(), heapOrder);
+    }
 }
@@ -9,7 +9,6 @@
 #include "CTL/DependencyGraph/Configuration.h"
 
 #include <algorithm>
-#include <random>
 
 namespace SearchStrategy {
 size_t RDFSSearch::Wsize() const {
@@ -28,7 +27,6 @@ void RDFSSearch::pushToW(DependencyGraph::Edge* edge) {
     W.push_back(edge);
 }
 
-auto rng = std::default_random_engine {};
 void RDFSSearch::flush() {
     last_parent = std::min(last_parent, W.size());
     std::shuffle(W.begin() + last_parent, W.end(), rng);
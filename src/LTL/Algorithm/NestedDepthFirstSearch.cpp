@@ -150,7 +150,7 @@ namespace LTL {
     template<typename S>
     void NestedDepthFirstSearch<S>::printStats(std::ostream &os)
     {
-        std::cout << "STATS:\n"
+        os << "STATS:\n"
                   << "\tdiscovered states:          " << _states.discovered() << std::endl
                   << "\tmax tokens:                 " << _states.max_tokens() << std::endl
                   << "\texplored states:            " << _mark_count[MARKER1] << std::endl
@@ -0,0 +1,240 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LTL/Algorithm/ParallelNestedDepthFirstSearch.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace LTL {
+
+    ParallelNestedDepthFirstSearch::ParallelNestedDepthFirstSearch(const PetriEngine::PetriNet *net,
+                                                                   const PetriEngine::PQL::Condition_ptr &query,
+                                                                   const Structures::BuchiAutomaton &buchi,
+                                                                   ResumingSuccessorGenerator *gen,
+                                                                   uint32_t threads, size_t seed, int kbound,
+                                                                   const PetriEngine::Reducer *reducer)
+            : ModelChecker<ProductSuccessorGenerator, ResumingSuccessorGenerator>(net, query, buchi, gen, reducer),
+              _kbound(kbound)
+    {
+        threads = std::max<uint32_t>(threads, 1);
+        // Building the product successor generators goes through spot, which is not thread-safe,
+        // so they are all made here. The search itself only reads the automaton.
+        for (uint32_t i = 0; i < threads; ++i) {
+            auto w = std::make_unique<worker_t>(this->_factory.newState(), this->_factory.newState(), seed + i);
+            if (i == 0) {
+                w->gen = this->successorGenerator.get();
+            } else {
+                w->own_gen = std::make_unique<ResumingSuccessorGenerator>(net);
+                w->own_product_gen = std::make_unique<ProductGen>(net, buchi, w->own_gen.get());
+                w->gen = w->own_product_gen.get();
+            }
+            _workers.emplace_back(std::move(w));
+        }
+    }
+
+    bool ParallelNestedDepthFirstSearch::isSatisfied()
+    {
+        this->is_weak = false;
+        _done = false;
+        _violation = false;
+        const uint32_t threads = _workers.size();
+        _states = std::make_unique<StateSet>(this->net, _kbound, this->successorGenerator->buchiStates(),
+                                             threads * 4, threads);
+        std::vector<State> initial = this->successorGenerator->makeInitialState();
+
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < threads; ++i) {
+            pool.emplace_back([this, i, &initial]() {
+                work(i, initial);
+            });
+        }
+        for (auto &t : pool)
+            t.join();
+
+        this->stats.explored = 0;
+        this->stats.expanded = 0;
+        for (auto &w : _workers) {
+            this->stats.explored += w->explored;
+            this->stats.expanded += w->expanded;
+        }
+        return !_violation;
+    }
+
+    void ParallelNestedDepthFirstSearch::work(size_t tid, const std::vector<State> &initial)
+    {
+        auto &w = *_workers[tid];
+        std::vector<successor_t> roots;
+        for (auto &state : initial) {
+            auto res = _states->add(state, tid);
+            if (res.id == StateSet::err_id)
+                continue;
+            roots.push_back(successor_t{res.id, res.info, w.gen->isAccepting(state)});
+        }
+        if (tid != 0)
+            std::shuffle(roots.begin(), roots.end(), w.rng);
+
+        for (auto &root : roots) {
+            if (root.info->red || (w.colours[root.id] & BLUE))
+                continue;
+            if (!blue(tid, w, root))
+                return;
+        }
+        // every state reachable from the initial states is blue, so there is no accepting cycle
+        _done = true;
+    }
+
+    bool ParallelNestedDepthFirstSearch::blue(size_t tid, worker_t &w, const successor_t &root)
+    {
+        size_t depth = 0;
+        w.colours[root.id] = CYAN;
+        expand(tid, w, push(w.blue_stack, depth++, root));
+        while (depth > 0) {
+            if (_done)
+                return false;
+            auto &top = w.blue_stack[depth - 1];
+            if (top.pending) {
+                top.pending = false;
+                if (!top.successors[top.next - 1].info->red)
+                    top.allred = false;
+            }
+            if (top.next < top.successors.size()) {
+                const auto succ = top.successors[top.next++];
+                auto &colour = w.colours[succ.id];
+                if ((colour & CYAN) && (top.state.accepting || succ.accepting)) {
+                    // cycle closed on the blue stack
+                    _violation = true;
+                    _done = true;
+                    return false;
+                }
+                if ((colour & (CYAN | BLUE)) == 0 && !succ.info->red) {
+                    colour = CYAN;
+                    top.pending = true;
+                    expand(tid, w, push(w.blue_stack, depth++, succ));
+                } else if (!succ.info->red) {
+                    top.allred = false;
+                }
+                continue;
+            }
+
+            if (top.allred) {
+                top.state.info->red = true;
+            } else if (top.state.accepting) {
+                if (!red(tid, w, top))
+                    return false;
+            }
+            w.colours[top.state.id] = BLUE;
+            --depth;
+        }
+        return true;
+    }
+
+    bool ParallelNestedDepthFirstSearch::red(size_t tid, worker_t &w, const frame_t &root)
+    {
+        const auto state = root.state;
+        ++state.info->count;
+        w.reds.clear();
+        w.reds.push_back(state);
+        w.colours[state.id] |= PINK;
+
+        // the successors of the root are already known from the blue search
+        size_t depth = 0;
+        push(w.red_stack, depth++, state).successors = root.successors;
+        while (depth > 0) {
+            if (_done)
+                return false;
+            auto &top = w.red_stack[depth - 1];
+            if (top.next < top.successors.size()) {
+                const auto succ = top.successors[top.next++];
+                auto &colour = w.colours[succ.id];
+                if (colour & CYAN) {
+                    // cycle back to the blue stack through an accepting state
+                    _violation = true;
+                    _done = true;
+                    return false;
+                }
+                if ((colour & PINK) == 0 && !succ.info->red) {
+                    colour |= PINK;
+                    w.reds.push_back(succ);
+                    expand(tid, w, push(w.red_stack, depth++, succ));
+                }
+                continue;
+            }
+            --depth;
+        }
+
+        // accepting states of the red search may still be in red searches of other threads
+        for (auto &r : w.reds) {
+            if (!r.accepting || r.id == state.id)
+                continue;
+            while (r.info->count != 0) {
+                if (_done)
+                    return false;
+                std::this_thread::yield();
+            }
+        }
+        for (auto &r : w.reds) {
+            r.info->red = true;
+            w.colours[r.id] &= ~PINK;
+        }
+        --state.info->count;
+        return true;
+    }
+
+    void ParallelNestedDepthFirstSearch::expand(size_t tid, worker_t &w, frame_t &frame)
+    {
+        _states->decode(w.parent, frame.state.id, tid);
+        auto sucinfo = ResumingSuccessorGenerator::initial_suc_info();
+        w.gen->prepare(&w.parent, sucinfo);
+        while (!_done && w.gen->next(w.working, sucinfo)) {
+            auto res = _states->add(w.working, tid);
+            if (res.id == StateSet::err_id)
+                continue;
+            if (res.is_new)
+                ++w.explored;
+            frame.successors.push_back(successor_t{res.id, res.info, w.gen->isAccepting(w.working)});
+        }
+        ++w.expanded;
+        // the threads only search different parts of the product if they order successors differently
+        if (tid != 0)
+            std::shuffle(frame.successors.begin(), frame.successors.end(), w.rng);
+    }
+
+    ParallelNestedDepthFirstSearch::frame_t &
+    ParallelNestedDepthFirstSearch::push(std::vector<frame_t> &stack, size_t depth, const successor_t &state)
+    {
+        // frames are reused to keep the capacity of their successor vectors
+        if (depth == stack.size())
+            stack.emplace_back();
+        auto &frame = stack[depth];
+        frame.state = state;
+        frame.successors.clear();
+        frame.next = 0;
+        frame.allred = true;
+        frame.pending = false;
+        return frame;
+    }
+
+    void ParallelNestedDepthFirstSearch::printStats(std::ostream &os)
+    {
+        os << "STATS:\n"
+           << "\tdiscovered states:          " << _states->discovered() << std::endl
+           << "\tmax tokens:                 " << _states->max_tokens() << std::endl
+           << "\texplored states:            " << this->stats.explored << std::endl
+           << "\texpanded states:            " << this->stats.expanded << std::endl
+           << "\tthreads:                    " << _workers.size() << std::endl;
+    }
+}
@@ -27,11 +27,14 @@ namespace LTL {
         State working = this->_factory.newState();
         State parent = this->_factory.newState();
         for (auto &state : initial_states) {
-            const auto res = _seen.add(state);
+            if (_seen->collision()) {
+                break;
+            }
+            const auto res = _seen->add(state);
             if (res.first) {
                 push(state, res.second);
             }
-            while (!_dstack.empty() && !_violation) {
+            while (!_dstack.empty() && !_violation && !_seen->collision()) {
                 DEntry &dtop = _dstack.top();
                 // write next successor state to working.
                 if (!nexttrans(working, parent, dtop)) {
@@ -52,25 +55,35 @@ namespace LTL {
                 }
 #endif
                 ++this->stats.explored;
-                const auto[isnew, stateid] = _seen.add(working);
+                const auto[isnew, stateid] = _seen->add(working);
                 if (stateid == std::numeric_limits<idx_t>::max()) {
                     continue;
                 }
 
                 if constexpr (SaveTrace) {
                     if (isnew) {
-                        _seen.setHistory(stateid, this->successorGenerator->fired());
+                        _seen->setHistory(stateid, this->successorGenerator->fired());
                     }
                 }
 
+                // keep the successor decodable for resuming successor generation
+                _seen->retain(stateid);
+                if (_seen->collision()) {
+                    // the successor hashes to a state on the stacks, so a loop closed through it
+                    // may not exist. Give up, the result is reported as inconclusive.
+                    break;
+                }
+                if (dtop._sucinfo.has_prev_state()) {
+                    _seen->release(dtop._sucinfo.last_state);
+                }
                 dtop._sucinfo.last_state = stateid;
 
                 // lookup successor in 'hash' table
-                auto suc_pos = _chash[hash(stateid)];
-                auto marking = _seen.getMarkingId(stateid);
+                auto suc_pos = _chash.find(_seen->getMarkingId(stateid));
                 while (suc_pos != std::numeric_limits<idx_t>::max() && _cstack[suc_pos]._stateid != stateid) {
                     if constexpr (_is_spooling) {
-                        if (_cstack[suc_pos]._dstack && _seen.getMarkingId(_cstack[suc_pos]._stateid) == marking) {
+                        // same marking in another Büchi state on the search path
+                        if (_cstack[suc_pos]._dstack) {
                             this->successorGenerator->generateAll(&parent, dtop._sucinfo);
                         }
                     }
@@ -87,7 +100,8 @@ namespace LTL {
                     update(suc_pos);
                     continue;
                 }
-                if (_store.find(stateid) == std::end(_store)) {
+                // a state not on the stack has been seen before iff it is finished
+                if (_seen->complete() ? !_store.contains(stateid) : isnew) {
                     push(working, stateid);
                 }
             }
@@ -104,7 +118,8 @@ namespace LTL {
                 }
             }
         }
-        return !_violation;
+        // after a collision the search was abandoned, so no violation can be claimed
+        return !_violation || _seen->collision();
     }
 
     /**
@@ -114,9 +129,10 @@ namespace LTL {
     template<template<typename, typename...> typename S, typename G, bool SaveTrace, typename... Spooler>
     void TarjanModelChecker<S, G, SaveTrace, Spooler...>::push(State &state, size_t stateid) {
         const auto ctop = static_cast<idx_t>(_cstack.size());
-        const auto h = hash(stateid);
-        _cstack.emplace_back(ctop, stateid, _chash[h]);
-        _chash[h] = ctop;
+        const auto marking = _seen->getMarkingId(stateid);
+        _seen->retain(stateid);
+        _cstack.emplace_back(ctop, stateid, _chash.find(marking));
+        _chash.set(marking, ctop);
         _dstack.push(DEntry{ctop});
         if (this->successorGenerator->isAccepting(state)) {
             _astack.push(ctop);
@@ -134,6 +150,9 @@ namespace LTL {
     void TarjanModelChecker<S, G, SaveTrace, Spooler...>::pop()
     {
         const auto p = _dstack.top()._pos;
+        if (_dstack.top()._sucinfo.has_prev_state()) {
+            _seen->release(_dstack.top()._sucinfo.last_state);
+        }
         _dstack.pop();
         _cstack[p]._dstack = false;
         if (_cstack[p]._lowlink == p) {
@@ -142,7 +161,7 @@ namespace LTL {
             }
         } else if (this->is_weak) {
             State state = this->_factory.newState();
-            _seen.decode(state, _cstack[p]._stateid);
+            _seen->decode(state, _cstack[p]._stateid);
             if (!this->successorGenerator->isAccepting(state)) {
                 popCStack();
             }
@@ -161,9 +180,16 @@ namespace LTL {
     template<template<typename, typename...> typename S, typename G, bool SaveTrace, typename... Spooler>
     void TarjanModelChecker<S, G, SaveTrace, Spooler...>::popCStack()
     {
-        auto h = hash(_cstack.back()._stateid);
-        _store.insert(_cstack.back()._stateid);
-        _chash[h] = _cstack.back()._next;
+        const auto marking = _seen->getMarkingId(_cstack.back()._stateid);
+        if (_seen->complete()) {
+            _store.insert(_cstack.back()._stateid);
+        }
+        _seen->release(_cstack.back()._stateid);
+        if (_cstack.back()._next == std::numeric_limits<idx_t>::max()) {
+            _chash.erase(marking);
+        } else {
+            _chash.set(marking, _cstack.back()._next);
+        }
         _cstack.pop_back();
     }
 
@@ -191,11 +217,11 @@ namespace LTL {
     template<template<typename, typename...> typename S, typename G, bool SaveTrace, typename... Spooler>
     bool TarjanModelChecker<S, G, SaveTrace, Spooler...>::nexttrans(State &state, State &parent, TarjanModelChecker::DEntry &delem)
     {
-        _seen.decode(parent, _cstack[delem._pos]._stateid);
+        _seen->decode(parent, _cstack[delem._pos]._stateid);
         this->successorGenerator->prepare(&parent, delem._sucinfo);
         // ensure that `state` buffer contains the correct state for Büchi successor generation.
         if (delem._sucinfo.has_prev_state()) {
-            _seen.decode(state, delem._sucinfo.last_state);
+            _seen->decode(state, delem._sucinfo.last_state);
         }
         auto res = this->successorGenerator->next(state, delem._sucinfo);
         return res;
@@ -221,7 +247,7 @@ namespace LTL {
                 p = dstack.top()._pos;
                 dstack.pop();
                 auto stateid = _cstack[p]._stateid;
-                auto[parent, tid] = _seen.getHistory(stateid);
+                auto[parent, tid] = _seen->getHistory(stateid);
                 this->printTransition(tid, os) << '\n';
                 if(tid >= std::numeric_limits<ptrie::uint>::max() - 1)
                 {
@@ -237,7 +263,7 @@ namespace LTL {
             {
                 p = _cstack[p]._lowsource;
                 while (_cstack[p]._lowlink != std::numeric_limits<idx_t>::max()) {
-                    auto[parent, tid] = _seen.getHistory(_cstack[p]._stateid);
+                    auto[parent, tid] = _seen->getHistory(_cstack[p]._stateid);
                     this->printTransition(tid, os) << '\n';
                     if(tid >= std::numeric_limits<ptrie::uint>::max() - 1)
                     {
@@ -24,7 +24,14 @@
 #include "LTL/SuccessorGeneration/Heuristics.h"
 //#include "LTL/SuccessorGeneration/HeuristicParser.h"
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <sstream>
 #include <utility>
+#ifdef VERIFYPN_MC_Simplification
+#include <thread>
+#endif
 
 using namespace PetriEngine::PQL;
 using namespace PetriEngine;
@@ -36,6 +43,7 @@ namespace LTL {
     struct Result {
         bool satisfied = false;
         bool is_weak = true;
+        bool complete = true;
         Algorithm algorithm = Algorithm::Tarjan;
 #ifdef DEBUG_EXPLORED_STATES
         size_t explored_states = 0;
@@ -70,21 +78,55 @@ namespace LTL {
         return std::make_pair(converted, should_negate);
     }
 
+    /**
+     * A single LTL query made ready for verification. Constructing the Büchi automaton and
+     * the model checker goes through spot, which is not thread-safe, whereas the search
+     * only reads the automaton. Jobs are therefore prepared one at a time but can be run
+     * concurrently.
+     */
+    struct LTLJob {
+        std::string queryName;
+        bool negate_answer = false;
+        bool is_stubborn = false;
+        bool is_visible_stub = false;
+        bool is_autreach_stub = false;
+        bool is_buchi_stub = false;
+        Algorithm algorithm = Algorithm::Tarjan;
+        BuchiOptimization buchiOptimization = BuchiOptimization::Low;
+        std::unique_ptr<Structures::BuchiAutomaton> automaton;
+        std::unique_ptr<Heuristic> heuristic;
+        std::unique_ptr<SuccessorSpooler> spooler;
+        std::unique_ptr<SpoolingSuccessorGenerator> spooling_gen;
+        std::unique_ptr<ResumingSuccessorGenerator> resuming_gen;
+        std::function<Result(std::ostream&)> verify;
+        // false if the search was possibly incomplete and found no counter-example
+        bool complete = true;
+        // number of threads searching the product
+        uint32_t threads = 1;
+
+        bool run(std::ostream &os);
+    };
+
     template<typename Checker>
-    Result _verify(std::unique_ptr<Checker> checker,
+    std::function<Result(std::ostream&)> _verify(std::unique_ptr<Checker> checker,
                    const options_t &options)
     {
-        Result result;
         checker->setOptions(options);
-        result.satisfied = checker->isSatisfied();
-        result.is_weak = checker->isweak();
+        std::shared_ptr<Checker> shared = std::move(checker);
+        bool printstatistics = options.printstatistics;
+        return [shared, printstatistics](std::ostream &os) {
+            Result result;
+            result.satisfied = shared->isSatisfied();
+            result.is_weak = shared->isweak();
+            result.complete = !result.satisfied || shared->isComplete();
 #ifdef DEBUG_EXPLORED_STATES
-        result.explored_states = checker->get_explored();
+            result.explored_states = shared->get_explored();
 #endif
-        if (options.printstatistics) {
-            checker->printStats(std::cout);
-        }
-        return result;
+            if (printstatistics) {
+                shared->printStats(os);
+            }
+            return result;
+        };
     }
 
     std::unique_ptr<Heuristic> make_heuristic(const PetriNet *net,
@@ -107,18 +149,25 @@ namespace LTL {
         }
     }
 
-    bool LTLMain(const PetriNet *net,
+    std::unique_ptr<LTLJob> prepareLTL(const PetriNet *net,
                         const Condition_ptr &query,
                         const std::string &queryName,
-                        options_t &options, const Reducer* reducer)
+                        options_t &options, const Reducer* reducer,
+                        uint32_t threads = 1)
     {
+        auto job = std::make_unique<LTLJob>();
+        job->queryName = queryName;
+        job->algorithm = options.ltlalgorithm;
+        job->buchiOptimization = options.buchiOptimization;
 
         // force AP compress off for Büchi prints
         options.ltl_compress_aps = options.buchi_out_file.empty() ? options.ltl_compress_aps : APCompression::None;
 
         auto [negated_formula, negate_answer] = to_ltl(query);
+        job->negate_answer = negate_answer;
 
-        Structures::BuchiAutomaton automaton = makeBuchiAutomaton(negated_formula, options);
+        job->automaton = std::make_unique<Structures::BuchiAutomaton>(makeBuchiAutomaton(negated_formula, options));
+        auto &automaton = *job->automaton;
         if (!options.buchi_out_file.empty()) {
             automaton.output_buchi(options.buchi_out_file, options.buchi_out_type);
         }
@@ -136,26 +185,47 @@ namespace LTL {
                 && !net->has_inhibitor();
 
         bool is_stubborn = options.ltl_por != LTLPartialOrder::None && (is_visible_stub || is_autreach_stub || is_buchi_stub);
+        job->is_visible_stub = is_visible_stub;
+        job->is_autreach_stub = is_autreach_stub;
+        job->is_buchi_stub = is_buchi_stub;
+        job->is_stubborn = is_stubborn;
 
-        std::unique_ptr<SuccessorSpooler> spooler;
-        std::unique_ptr<Heuristic> heuristic = make_heuristic(net, negated_formula, automaton, options);
+        auto &spooler = job->spooler;
+        auto &heuristic = job->heuristic;
+        heuristic = make_heuristic(net, negated_formula, automaton, options);
 
-        Result result;
+        auto &verify = job->verify;
         switch (options.ltlalgorithm) {
             case Algorithm::NDFS:
+#ifdef VERIFYPN_MC_Simplification
+                if (threads > 1 && options.trace == TraceLevel::None) {
+                    // every thread searches depth-first in its own random order, heuristics are not used
+                    heuristic = nullptr;
+                    job->threads = threads;
+                    job->resuming_gen = std::make_unique<ResumingSuccessorGenerator>(net);
+                    verify = _verify(
+                            std::make_unique<ParallelNestedDepthFirstSearch>(
+                                    net, negated_formula, automaton, job->resuming_gen.get(), threads,
+                                    options.seed(), options.kbound, reducer),
+                            options);
+                    break;
+                }
+#endif
                 if (options.strategy != PetriEngine::Reachability::DFS) {
-                    SpoolingSuccessorGenerator gen{net, negated_formula};
+                    job->spooling_gen = std::make_unique<SpoolingSuccessorGenerator>(net, negated_formula);
+                    auto &gen = *job->spooling_gen;
                     spooler = std::make_unique<EnabledSpooler>(net, gen);
                     gen.setSpooler(spooler.get());
                     gen.setHeuristic(heuristic.get());
-                    result = _verify(
+                    verify = _verify(
                             std::make_unique<NestedDepthFirstSearch<SpoolingSuccessorGenerator>>(
                                     net, negated_formula, automaton, &gen, options.trace != TraceLevel::None, options.kbound, reducer),
                             options);
 
                 } else {
-                    ResumingSuccessorGenerator gen{net};
-                    result = _verify(
+                    job->resuming_gen = std::make_unique<ResumingSuccessorGenerator>(net);
+                    auto &gen = *job->resuming_gen;
+                    verify = _verify(
                             std::make_unique<NestedDepthFirstSearch<ResumingSuccessorGenerator>>(
                                     net, negated_formula, automaton, &gen, options.trace != TraceLevel::None, options.kbound, reducer),
                             options);
@@ -166,7 +236,8 @@ namespace LTL {
                 if (options.strategy != PetriEngine::Reachability::DFS || is_stubborn) {
                     // Use spooling successor generator in case of different search strategy or stubborn set method.
                     // Running default, BestFS, or RDFS search strategy so use spooling successor generator to enable heuristics.
-                    SpoolingSuccessorGenerator gen{net, negated_formula};
+                    job->spooling_gen = std::make_unique<SpoolingSuccessorGenerator>(net, negated_formula);
+                    auto &gen = *job->spooling_gen;
                     if (is_visible_stub) {
                         spooler = std::make_unique<VisibleLTLStubbornSet>(*net, negated_formula);
                     } else if (is_buchi_stub) {
@@ -187,7 +258,7 @@ namespace LTL {
 
                     if (options.trace != TraceLevel::None) {
                         if (is_autreach_stub && is_visible_stub) {
-                            result = _verify(std::make_unique<TarjanModelChecker<ReachStubProductSuccessorGenerator, SpoolingSuccessorGenerator, true, VisibleLTLStubbornSet>>(
+                            verify = _verify(std::make_unique<TarjanModelChecker<ReachStubProductSuccessorGenerator, SpoolingSuccessorGenerator, true, VisibleLTLStubbornSet>>(
                                                      net,
                                                      negated_formula,
                                                      automaton,
@@ -197,7 +268,7 @@ namespace LTL {
                                              options);
                         }
                         else if (is_autreach_stub && !is_visible_stub) {
-                            result = _verify(std::make_unique<TarjanModelChecker<ReachStubProductSuccessorGenerator, SpoolingSuccessorGenerator, true, EnabledSpooler>>(
+                            verify = _verify(std::make_unique<TarjanModelChecker<ReachStubProductSuccessorGenerator, SpoolingSuccessorGenerator, true, EnabledSpooler>>(
                                                      net,
                                                      negated_formula,
                                                      automaton,
@@ -207,7 +278,7 @@ namespace LTL {
                                              options);
                         }
                         else {
-                            result = _verify(std::make_unique<TarjanModelChecker<ProductSuccessorGenerator, SpoolingSuccessorGenerator, true>>(
+                            verify = _verify(std::make_unique<TarjanModelChecker<ProductSuccessorGenerator, SpoolingSuccessorGenerator, true>>(
                                                      net,
                                                      negated_formula,
                                                      automaton,
@@ -218,7 +289,7 @@ namespace LTL {
                     } else {
 
                         if (is_autreach_stub && is_visible_stub) {
-                            result = _verify(std::make_unique<TarjanModelChecker<ReachStubProductSuccessorGenerator, SpoolingSuccessorGenerator, false, VisibleLTLStubbornSet>>(
+                            verify = _verify(std::make_unique<TarjanModelChecker<ReachStubProductSuccessorGenerator, SpoolingSuccessorGenerator, false, VisibleLTLStubbornSet>>(
                                                      net,
                                                      negated_formula,
                                                      automaton,
@@ -227,7 +298,7 @@ namespace LTL {
                                                      std::make_unique<VisibleLTLStubbornSet>(*net, negated_formula)),
                                              options);
                         } else if (is_autreach_stub && !is_visible_stub) {
-                            result = _verify(std::make_unique<TarjanModelChecker<ReachStubProductSuccessorGenerator, SpoolingSuccessorGenerator, false, EnabledSpooler>>(
+                            verify = _verify(std::make_unique<TarjanModelChecker<ReachStubProductSuccessorGenerator, SpoolingSuccessorGenerator, false, EnabledSpooler>>(
                                                      net,
                                                      negated_formula,
                                                      automaton,
@@ -237,7 +308,7 @@ namespace LTL {
                                              options);
                         }
                         else {
-                            result = _verify(std::make_unique<TarjanModelChecker<ProductSuccessorGenerator, SpoolingSuccessorGenerator, false>>(
+                            verify = _verify(std::make_unique<TarjanModelChecker<ProductSuccessorGenerator, SpoolingSuccessorGenerator, false>>(
                                                      net,
                                                      negated_formula,
                                                      automaton,
@@ -247,11 +318,12 @@ namespace LTL {
                         }
                     }
                 } else {
-                    ResumingSuccessorGenerator gen{net};
+                    job->resuming_gen = std::make_unique<ResumingSuccessorGenerator>(net);
+                    auto &gen = *job->resuming_gen;
 
                     // no spooling needed, thus use resuming successor generation
                     if (options.trace != TraceLevel::None) {
-                        result = _verify(std::make_unique<TarjanModelChecker<ProductSuccessorGenerator, ResumingSuccessorGenerator, true>>(
+                        verify = _verify(std::make_unique<TarjanModelChecker<ProductSuccessorGenerator, ResumingSuccessorGenerator, true>>(
                                                  net,
                                                  negated_formula,
                                                  automaton,
@@ -259,7 +331,7 @@ namespace LTL {
                                                  options.kbound, reducer),
                                          options);
                     } else {
-                        result = _verify(std::make_unique<TarjanModelChecker<ProductSuccessorGenerator, ResumingSuccessorGenerator, false>>(
+                        verify = _verify(std::make_unique<TarjanModelChecker<ProductSuccessorGenerator, ResumingSuccessorGenerator, false>>(
                                                  net,
                                                  negated_formula,
                                                  automaton,
@@ -273,22 +345,97 @@ namespace LTL {
                 assert(false);
                 std::cerr << "Error: cannot LTL verify with algorithm None";
         }
-        std::cout << "FORMULA " << queryName
+        return job;
+    }
+
+    bool LTLJob::run(std::ostream &os)
+    {
+        Result result = verify(os);
+        complete = result.complete;
+        if (!complete) {
+            os << "FORMULA " << queryName << " CANNOT_COMPUTE" << std::endl;
+            return false;
+        }
+        os << "FORMULA " << queryName
                   << (result.satisfied ^ negate_answer ? " TRUE" : " FALSE") << " TECHNIQUES EXPLICIT "
-                  << LTL::to_string(options.ltlalgorithm)
+                  << LTL::to_string(algorithm)
+                  << (threads > 1 ? " PARALLEL" : "")
                   << (result.is_weak ? " WEAK_SKIP" : "")
                   << (is_stubborn ? " STUBBORN" : "")
                   << (is_visible_stub ? " CLASSIC_STUB" : "")
                   << (is_autreach_stub ? " REACH_STUB" : "")
                   << (is_buchi_stub ? " BUCHI_STUB" : "");
         if (heuristic != nullptr) {
-            std::cout << " HEURISTIC ";
-            heuristic->output(std::cout);
+            os << " HEURISTIC ";
+            heuristic->output(os);
         }
-        std::cout << " OPTIM-" << static_cast<int>(options.buchiOptimization) << std::endl;
+        os << " OPTIM-" << static_cast<int>(buchiOptimization) << std::endl;
 #ifdef DEBUG_EXPLORED_STATES
-        std::cout << "FORMULA " << queryName << " STATS EXPLORED " << result.explored_states << std::endl;
+        os << "FORMULA " << queryName << " STATS EXPLORED " << result.explored_states << std::endl;
 #endif
         return result.satisfied ^ negate_answer;
     }
+
+    bool LTLMain(const PetriNet *net,
+                        const Condition_ptr &query,
+                        const std::string &queryName,
+                        options_t &options, const Reducer* reducer)
+    {
+        auto job = prepareLTL(net, query, queryName, options, reducer, options.cores);
+        return job->run(std::cout);
+    }
+
+    void LTLMain(const PetriNet *net,
+                 const std::vector<Condition_ptr> &queries,
+                 const std::vector<std::string> &querynames,
+                 const std::vector<size_t> &ids,
+                 options_t &options, const Reducer* reducer)
+    {
+        auto report = [&querynames](std::ostream &os, size_t qid, const LTLJob &job, bool res) {
+            if (!job.complete) {
+                os << "\nUnable to decide if " << querynames[qid] << " is satisfied.\n\n";
+                os << "Query is MAYBE satisfied.\n";
+                os << "The search is possibly incomplete (bitstate hashing)." << std::endl;
+                return;
+            }
+            os << "\nQuery index " << qid << " was solved\n";
+            os << "Query is " << (res ? "" : "NOT ") << "satisfied." << std::endl;
+        };
+#ifdef VERIFYPN_MC_Simplification
+        // traces are printed while searching and cannot be buffered
+        size_t nthreads = std::min<size_t>(options.cores, ids.size());
+        if (nthreads > 1 && options.trace == TraceLevel::None) {
+            // spare cores go to the search of the individual queries
+            uint32_t job_threads = std::max<uint32_t>(1, options.cores / nthreads);
+            std::vector<std::unique_ptr<LTLJob>> jobs;
+            for (auto qid : ids)
+                jobs.emplace_back(prepareLTL(net, queries[qid], querynames[qid], options, reducer, job_threads));
+
+            std::atomic<size_t> next(0);
+            std::mutex out_lock;
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < nthreads; ++t) {
+                threads.emplace_back([&]() {
+                    while (true) {
+                        auto i = next++;
+                        if (i >= jobs.size()) return;
+                        std::stringstream ss;
+                        auto res = jobs[i]->run(ss);
+                        report(ss, ids[i], *jobs[i], res);
+                        std::lock_guard<std::mutex> lock(out_lock);
+                        std::cout << ss.str() << std::flush;
+                    }
+                });
+            }
+            for (auto &t : threads)
+                t.join();
+            return;
+        }
+#endif
+        for (auto qid : ids) {
+            auto job = prepareLTL(net, queries[qid], querynames[qid], options, reducer, options.cores);
+            auto res = job->run(std::cout);
+            report(std::cout, qid, *job, res);
+        }
+    }
 }
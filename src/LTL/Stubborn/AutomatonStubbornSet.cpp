@@ -20,6 +20,8 @@
 #include "LTL/Stubborn/EvalAndSetVisitor.h"
 #include "PetriEngine/Stubborn/InterestingTransitionVisitor.h"
 
+#include <map>
+
 using namespace PetriEngine;
 using namespace PetriEngine::PQL;
 
@@ -159,7 +161,7 @@ namespace LTL {
         }
 
 
-        GuardInfo buchi_state = _state_guards[state->getBuchiState()];
+        const GuardInfo &buchi_state = _state_guards[state->getBuchiState()];
 
         PQL::EvaluationContext evaluationContext{_parent->marking(), &_net};
 
@@ -347,6 +349,19 @@ namespace LTL {
         _done = true;
     }
 
+    void AutomatonStubbornSet::_compute_guard_classes()
+    {
+        // the stubborn set only depends on the guards of the Büchi state, not on where they lead
+        std::map<std::vector<int>, size_t> classes;
+        _guard_classes.reserve(_state_guards.size());
+        for (auto &guards : _state_guards) {
+            std::vector<int> key{guards.is_accepting, guards.retarding.decision_diagram.id()};
+            for (auto &q : guards.progressing)
+                key.push_back(q.decision_diagram.id());
+            _guard_classes.push_back(classes.emplace(std::move(key), classes.size()).first->second);
+        }
+    }
+
     bool AutomatonStubbornSet::_closure()
     {
         StubbornSet::closure([&]() { return !_bad; });
@@ -45,8 +45,8 @@ namespace PetriEngine {
     }
 
     NaiveBindingGenerator::NaiveBindingGenerator(const Colored::Transition& transition,
-            Colored::ColorTypeMap& colorTypes)
-        : _colorTypes(colorTypes)
+            Colored::ColorTypeMap& colorTypes, Colored::CompiledTransition& compiled)
+        : _colorTypes(colorTypes), _compiled(compiled)
     {
         _expr = transition.guard;
         std::set<const Colored::Variable*> variables;
@@ -72,10 +72,8 @@ namespace PetriEngine {
     bool NaiveBindingGenerator::eval() const {
         if (_expr == nullptr)
             return true;
-        Colored::EquivalenceVec placePartition;
-
-        const Colored::ExpressionContext &context {_bindings, _colorTypes, placePartition};
-        return _expr->eval(context);
+        _compiled.bind(_bindings);
+        return _compiled.evalGuard();
     }
 
     const Colored::BindingMap& NaiveBindingGenerator::nextBinding() {
@@ -146,8 +144,9 @@ namespace PetriEngine {
     }
 
     FixpointBindingGenerator::FixpointBindingGenerator(const Colored::Transition& transition,
-        const Colored::ColorTypeMap& colorTypes,  const std::vector<std::set<const Colored::Variable *>>& symmetric_vars)
-    : _expr(transition.guard), _colorTypes(colorTypes), _transition(transition), _symmetric_vars(symmetric_vars)
+        const Colored::ColorTypeMap& colorTypes,  const std::vector<std::set<const Colored::Variable *>>& symmetric_vars,
+        Colored::CompiledTransition& compiled)
+    : _expr(transition.guard), _colorTypes(colorTypes), _transition(transition), _compiled(compiled), _symmetric_vars(symmetric_vars)
     {
         _isDone = false;
         _noValidBindings = false;
@@ -219,9 +218,8 @@ namespace PetriEngine {
         if (_expr == nullptr)
             return true;
 
-        Colored::EquivalenceVec placePartition;
-        const Colored::ExpressionContext &context {_bindings, _colorTypes, placePartition};
-        return _expr->eval(context);
+        _compiled.bind(_bindings);
+        return _compiled.evalGuard();
     }
 
     const Colored::BindingMap& FixpointBindingGenerator::nextBinding() {
@@ -18,7 +18,10 @@
  */
 
 #include "PetriEngine/Colored/ColoredPetriNetBuilder.h"
+#include <atomic>
 #include <chrono>
+#include <limits>
+#include <thread>
 #include <tuple>
 using std::get;
 namespace PetriEngine {
@@ -626,7 +629,7 @@ namespace PetriEngine {
 
     //----------------------- Unfolding -----------------------//
 
-    PetriNetBuilder& ColoredPetriNetBuilder::unfold() {
+    PetriNetBuilder& ColoredPetriNetBuilder::unfold(uint32_t threads) {
         if (_stripped) assert(false);
         if (_isColored && !_unfolded) {
             auto start = std::chrono::high_resolution_clock::now();
@@ -639,8 +642,13 @@ namespace PetriEngine {
                 createPartionVarmaps();
             }
             
-            for(uint32_t transitionId = 0; transitionId < _transitions.size(); transitionId++){
-                unfoldTransition(transitionId);
+            prepareUnfolding();
+            if(threads > 1 && _transitions.size() > 1){
+                unfoldTransitions(threads);
+            } else {
+                for(uint32_t transitionId = 0; transitionId < _transitions.size(); transitionId++){
+                    unfoldTransition(transitionId);
+                }
             }
 
             const auto& unfoldedPlaceMap = _ptBuilder.getPlaceNames();
@@ -680,7 +688,7 @@ namespace PetriEngine {
         }     
     }
     
-    void ColoredPetriNetBuilder::unfoldPlace(const Colored::Place* place, const PetriEngine::Colored::Color *color, uint32_t placeId, uint32_t id) {        
+    uint32_t ColoredPetriNetBuilder::unfoldPlace(const Colored::Place* place, const PetriEngine::Colored::Color *color, uint32_t placeId, uint32_t id) {        
         size_t tokenSize = 0;
 
         if(!_partitionComputed || _partition[placeId].isDiagonal()){
@@ -707,77 +715,186 @@ namespace PetriEngine {
                 }                    
             }
         } 
-        const std::string &name = place->name + "_" + std::to_string(color->getId());
+        std::string name = place->name + "_" + std::to_string(color->getId());
 
-        _ptBuilder.addPlace(name, tokenSize, 0.0, 0.0);
+        const uint32_t ptPlaceId = _ptBuilder.addNewPlace(name, tokenSize, 0.0, 0.0);
         _ptplacenames[place->name][id] = std::move(name);
+        _ptPlaceIds[placeId].emplace(id, ptPlaceId);
+        return ptPlaceId;
     }
 
-    void ColoredPetriNetBuilder::unfoldTransition(uint32_t transitionId) {
-        const Colored::Transition &transition = _transitions[transitionId];
-        if(_fixpointDone || _partitionComputed){ 
-            FixpointBindingGenerator gen(transition, _colors, symmetric_var_map[transitionId]);
-            size_t i = 0;
-            bool hasBindings = false;
-            for (const auto &b : gen) {  
-                const std::string &name = transition.name + "_" + std::to_string(i++);
-              
-                hasBindings = true;            
-                _ptBuilder.addTransition(name, 0.0, 0.0);
-                
-                for (auto& arc : transition.input_arcs) {
-                    unfoldArc(arc, b, name);
+    uint32_t ColoredPetriNetBuilder::unfoldSumPlace(uint32_t placeId) {
+        uint32_t &ptPlaceId = _sumPlaceIds[placeId];
+        if(ptPlaceId == std::numeric_limits<uint32_t>::max()){
+            const PetriEngine::Colored::Place& place = _places[placeId];
+            ptPlaceId = _ptBuilder.addNewPlace(place.name + "Sum", place.marking.size(), 0.0, 0.0);
+        }
+        return ptPlaceId;
+    }
+
+    //The maps used when computing bindings get all their entries up front, as the bindings may be computed in parallel
+    void ColoredPetriNetBuilder::prepareUnfolding() {
+        _ptPlaceIds.resize(_places.size());
+        _sumPlaceIds.resize(_places.size(), std::numeric_limits<uint32_t>::max());
+        _ptTransitionCounts.resize(_transitions.size(), std::numeric_limits<uint32_t>::max());
+        for(uint32_t transitionId = 0; transitionId < _transitions.size(); transitionId++){
+            const Colored::Transition &transition = _transitions[transitionId];
+            if(_fixpointDone || _partitionComputed){
+                symmetric_var_map[transitionId];
+            }
+            for(const auto* arcs : {&transition.input_arcs, &transition.output_arcs}){
+                for(const auto& arc : *arcs){
+                    if(!(_fixpointDone && _places[arc.place].stable)){
+                        _partition[arc.place];
+                    }
                 }
-                for (auto& arc : transition.output_arcs) {
-                    unfoldArc(arc, b, name);
+            }
+        }
+    }
+
+    void ColoredPetriNetBuilder::unfoldTransition(uint32_t transitionId) {
+        UnfoldedTransition unfolded;
+        computeBindings(transitionId, unfolded);
+        addUnfoldedTransition(transitionId, unfolded);
+    }
+
+    //Workers compute the bindings of the transitions in order of their ids and this thread adds them to
+    //_ptBuilder in the same order, helping the workers while the next transition is not done.
+    //Workers stay at most a few transitions per thread ahead of this thread, so only the arcs of those
+    //transitions are held besides what has already been added to _ptBuilder
+    void ColoredPetriNetBuilder::unfoldTransitions(uint32_t threads) {
+        const uint32_t ntransitions = _transitions.size();
+        const uint32_t window = 4 * threads;
+        std::vector<UnfoldedTransition> unfolded(ntransitions);
+        std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[ntransitions]);
+        for(uint32_t i = 0; i < ntransitions; i++){
+            done[i] = false;
+        }
+        std::atomic<uint32_t> next(0);
+        //Transitions before added have been added to _ptBuilder
+        std::atomic<uint32_t> added(0);
+        //Takes the next transition if it is within the window, returns ntransitions otherwise
+        auto claim = [&](){
+            uint32_t id = next.load();
+            while(id < ntransitions && id < added.load(std::memory_order_acquire) + window){
+                if(next.compare_exchange_weak(id, id + 1)){
+                    return id;
                 }
-                
-                _pttransitionnames[transition.name].push_back(std::move(name));
-                unfoldInhibitorArc(transition.name, name);                
-            }                            
-            if(!hasBindings){
-                _pttransitionnames[transition.name] = std::vector<std::string>();
-            }           
-        } else {
-            NaiveBindingGenerator gen(transition, _colors);
-            size_t i = 0;
-            for (const auto &b : gen) {    
-                const std::string &name = transition.name + "_" + std::to_string(i++);
-                _ptBuilder.addTransition(name, 0.0, 0.0);
-                
-                for (const auto& arc : transition.input_arcs) {
-                    unfoldArc(arc, b, name);
+            }
+            return ntransitions;
+        };
+        auto work = [&](){
+            while(next.load() < ntransitions){
+                uint32_t id = claim();
+                if(id < ntransitions){
+                    computeBindings(id, unfolded[id]);
+                    done[id].store(true, std::memory_order_release);
+                } else {
+                    std::this_thread::yield();
                 }
-                for (const auto& arc : transition.output_arcs) {
-                    unfoldArc(arc, b, name);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for(uint32_t i = 1; i < std::min(threads, ntransitions); i++){
+            workers.emplace_back(work);
+        }
+        for(uint32_t transitionId = 0; transitionId < ntransitions; transitionId++){
+            while(!done[transitionId].load(std::memory_order_acquire)){
+                uint32_t id = claim();
+                if(id < ntransitions){
+                    computeBindings(id, unfolded[id]);
+                    done[id].store(true, std::memory_order_release);
+                } else {
+                    std::this_thread::yield();
                 }
-                _pttransitionnames[transition.name].push_back(std::move(name));
-                unfoldInhibitorArc(transition.name, name);
             }
+            addUnfoldedTransition(transitionId, unfolded[transitionId]);
+            //Free the arcs right away, the vector itself only holds empty entries
+            unfolded[transitionId] = UnfoldedTransition();
+            added.store(transitionId + 1, std::memory_order_release);
+        }
+        for(auto& worker : workers){
+            worker.join();
         }
     }
 
-    void ColoredPetriNetBuilder::unfoldInhibitorArc(const std::string &oldname, const std::string &newname) {
+    void ColoredPetriNetBuilder::computeBindings(uint32_t transitionId, UnfoldedTransition& unfolded) {
+        const Colored::Transition &transition = _transitions[transitionId];
+        Colored::CompiledTransition compiled(transition, _colors);
+        auto unfoldBinding = [&](const Colored::BindingMap& b){
+            compiled.bind(b);
+            for (uint32_t i = 0; i < transition.input_arcs.size(); i++) {
+                unfoldArc(transition.input_arcs[i], compiled, i, unfolded.arcs);
+            }
+            for (uint32_t i = 0; i < transition.output_arcs.size(); i++) {
+                unfoldArc(transition.output_arcs[i], compiled, i, unfolded.arcs);
+            }
+            unfolded.bindingEnd.push_back(unfolded.arcs.size());
+        };
+        if(_fixpointDone || _partitionComputed){
+            FixpointBindingGenerator gen(transition, _colors, symmetric_var_map.find(transitionId)->second, compiled);
+            for (const auto &b : gen) {
+                unfoldBinding(b);
+            }
+        } else {
+            NaiveBindingGenerator gen(transition, _colors, compiled);
+            for (const auto &b : gen) {
+                unfoldBinding(b);
+            }
+        }
+    }
+
+    void ColoredPetriNetBuilder::addUnfoldedTransition(uint32_t transitionId, const UnfoldedTransition& unfolded) {
+        if(unfolded.bindingEnd.empty()){
+            if(_fixpointDone || _partitionComputed){
+                _ptTransitionCounts[transitionId] = 0;
+            }
+            return;
+        }
+        const uint32_t first = _ptBuilder.addNewTransitions(_transitions[transitionId].name, unfolded.bindingEnd.size());
+        _ptTransitionCounts[transitionId] = unfolded.bindingEnd.size();
+        size_t arc = 0;
+        for (size_t i = 0; i < unfolded.bindingEnd.size(); i++) {
+            for (; arc < unfolded.bindingEnd[i]; arc++) {
+                addUnfoldedArc(unfolded.arcs[arc], first + i);
+            }
+            unfoldInhibitorArc(transitionId, first + i);
+        }
+    }
+
+    void ColoredPetriNetBuilder::unfoldInhibitorArc(uint32_t transitionId, uint32_t ptTransitionId) {
         for (uint32_t i = 0; i < _inhibitorArcs.size(); ++i) {
-            if (_transitions[_inhibitorArcs[i].transition].name.compare(oldname) == 0) {
+            if (_inhibitorArcs[i].transition == transitionId) {
                 const Colored::Arc &inhibArc = _inhibitorArcs[i];
-                const std::string& placeName = _sumPlacesNames[inhibArc.place];
-
-                if(placeName.empty()){
-                    const PetriEngine::Colored::Place& place = _places[inhibArc.place]; 
-                    const std::string &sumPlaceName = place.name + "Sum";
-                    _ptBuilder.addPlace(sumPlaceName, place.marking.size(),0.0,0.0);
-                    if(_ptplacenames.count(place.name) <= 0){
-                        _ptplacenames[place.name][0] = sumPlaceName;
-                    }
-                    _sumPlacesNames[inhibArc.place] = std::move(sumPlaceName);
+                const PetriEngine::Colored::Place& place = _places[inhibArc.place];
+                if(_sumPlaceIds[inhibArc.place] == std::numeric_limits<uint32_t>::max() && _ptplacenames.count(place.name) <= 0){
+                    _ptplacenames[place.name][0] = place.name + "Sum";
                 }
-                _ptBuilder.addInputArc(placeName, newname, true, inhibArc.weight);
+                _ptBuilder.addInputArc(unfoldSumPlace(inhibArc.place), ptTransitionId, true, inhibArc.weight);
             }
         }
     }
 
-    void ColoredPetriNetBuilder::unfoldArc(const Colored::Arc& arc, const Colored::BindingMap& binding, const std::string& tName) {
+    const ColoredPetriNetBuilder::PTTransitionMap& ColoredPetriNetBuilder::getUnfoldedTransitionNames() {
+        for(uint32_t transitionId = 0; transitionId < _ptTransitionCounts.size(); transitionId++){
+            const uint32_t count = _ptTransitionCounts[transitionId];
+            if(count == std::numeric_limits<uint32_t>::max()){
+                continue;
+            }
+            const std::string& name = _transitions[transitionId].name;
+            auto& names = _pttransitionnames[name];
+            names.reserve(count);
+            for(uint32_t i = 0; i < count; i++){
+                names.push_back(name + "_" + std::to_string(i));
+            }
+        }
+        _ptTransitionCounts.clear();
+        _ptTransitionCounts.shrink_to_fit();
+        return _pttransitionnames;
+    }
+
+    void ColoredPetriNetBuilder::unfoldArc(const Colored::Arc& arc, Colored::CompiledTransition& compiled, uint32_t arcIndex, std::vector<UnfoldedArc>& arcs) const {
         const PetriEngine::Colored::Place& place = _places[arc.place];
         //If the place is stable, the arc does not need to be unfolded.
         //This exploits the fact that since the transition is being unfolded with this binding
@@ -787,9 +904,10 @@ namespace PetriEngine {
             return;
         } 
         
-        const Colored::ExpressionContext &context {binding, _colors, _partition[arc.place]};
-        const auto &ms = arc.expr->eval(context);   
-        int shadowWeight = 0;
+        const Colored::EquivalenceVec &partition = _partition.find(arc.place)->second;
+        const auto &ms = arc.input ? compiled.evalInputArc(arcIndex, partition)
+                                   : compiled.evalOutputArc(arcIndex, partition);
+        uint32_t shadowWeight = 0;
 
         const Colored::Color *newColor;
         std::vector<uint32_t> tupleIds;
@@ -798,55 +916,56 @@ namespace PetriEngine {
                 continue;
             }
  
-            if(!_partitionComputed || _partition[arc.place].isDiagonal()){
+            if(!_partitionComputed || partition.isDiagonal()){
                 newColor = color.first;
             } else {
                 tupleIds.clear();
                 color.first->getTupleId(tupleIds);
 
-                _partition[arc.place].applyPartition(tupleIds);
+                partition.applyPartition(tupleIds);
                 newColor = place.type->getColor(tupleIds);
             }
             
             shadowWeight += color.second;
             uint32_t id;
-            if(!_partitionComputed || _partition[arc.place].isDiagonal()){
+            if(!_partitionComputed || partition.isDiagonal()){
                 id = newColor->getId();
             } else {
-                id = _partition[arc.place].getUniqueIdForColor(newColor);                
+                id = partition.getUniqueIdForColor(newColor);                
             }
-            const std::string& pName = _ptplacenames[place.name][id];
+            arcs.push_back(UnfoldedArc{newColor, arc.place, id, color.second, arc.input});
+        }
 
-            if (pName.empty()) {                               
-                unfoldPlace(&place, newColor, arc.place, id);               
-            }
+        if(place.inhibitor){
+            arcs.push_back(UnfoldedArc{nullptr, arc.place, 0, shadowWeight, arc.input});
+        }       
+    }
+
+    void ColoredPetriNetBuilder::addUnfoldedArc(const UnfoldedArc& arc, uint32_t ptTransitionId) {
+        if(arc.color != nullptr){
+            const auto& ptPlaceIds = _ptPlaceIds[arc.place];
+            auto it = ptPlaceIds.find(arc.id);
+            const uint32_t ptPlaceId = it != ptPlaceIds.end() ? it->second
+                                                               : unfoldPlace(&_places[arc.place], arc.color, arc.place, arc.id);
 
             if (arc.input) {
-                _ptBuilder.addInputArc(pName, tName, false, color.second);
+                _ptBuilder.addInputArc(ptPlaceId, ptTransitionId, false, arc.weight);
             } else {
-                _ptBuilder.addOutputArc(tName, pName, color.second);
+                _ptBuilder.addOutputArc(ptTransitionId, ptPlaceId, arc.weight);
             }
             ++_nptarcs;
-        }
-
-        if(place.inhibitor){
-            const std::string &sumPlaceName = _sumPlacesNames[arc.place];
-            if(sumPlaceName.empty()){
-                const std::string &newSumPlaceName = place.name + "Sum";
-                _ptBuilder.addPlace(newSumPlaceName, place.marking.size(),0.0,0.0);
-                _sumPlacesNames[arc.place] = std::move(newSumPlaceName);
-            }
-            
+        } else {
+            const uint32_t ptPlaceId = unfoldSumPlace(arc.place);
 
-            if(shadowWeight > 0) {
+            if(arc.weight > 0) {
                 if (!arc.input) {
-                    _ptBuilder.addOutputArc(tName, sumPlaceName, shadowWeight);
+                    _ptBuilder.addOutputArc(ptTransitionId, ptPlaceId, arc.weight);
                 } else {
-                    _ptBuilder.addInputArc(sumPlaceName, tName, false, shadowWeight);
+                    _ptBuilder.addInputArc(ptPlaceId, ptTransitionId, false, arc.weight);
                 }
                 ++_nptarcs;
             }
-        }       
+        }
     }
 
     //----------------------- Strip Colors -----------------------//
@@ -0,0 +1,243 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "PetriEngine/Colored/ColoredSuccessorGenerator.h"
+
+namespace PetriEngine {
+    namespace Colored {
+        ColoredSuccessorGenerator::ColoredSuccessorGenerator(const PetriNet& net, const ColoredPetriNetBuilder& builder)
+                : _builder(builder), _netPlaces(Structures::strippedPlaceIds(net, builder.getPlaces()))
+        {
+            std::unordered_map<std::string, uint32_t> transitionIds;
+            for (uint32_t i = 0; i < net.numberOfTransitions(); ++i) {
+                transitionIds[net.transitionNames()[i]] = i;
+            }
+
+            const auto& transitions = builder.getTransitions();
+            _compiled.reserve(transitions.size());
+            _info.resize(transitions.size());
+            for (uint32_t t = 0; t < transitions.size(); ++t) {
+                const auto& transition = transitions[t];
+                _compiled.emplace_back(transition, builder.getColorTypes());
+                assert(transitionIds.count(transition.name) == 1);
+                _netTransitions.push_back(transitionIds[transition.name]);
+
+                auto& info = _info[t];
+                for (uint32_t i = 0; i < transition.input_arcs.size(); ++i) {
+                    const auto& arc = transition.input_arcs[i];
+                    auto it = std::find_if(info.inputs.begin(), info.inputs.end(), [&](const InputPlace& in) {
+                        return in.place == arc.place;
+                    });
+                    if (it == info.inputs.end()) {
+                        info.inputs.push_back({arc.place, {}, 0});
+                        it = info.inputs.end() - 1;
+                    }
+                    it->arcs.push_back(i);
+                    try {
+                        it->weight += arc.expr->weight();
+                    } catch (WeightException&) {
+                        //The number of tokens depends on the binding
+                    }
+                }
+
+                const auto& compiled = _compiled.back();
+                info.tokens.resize(compiled.variables().size());
+                for (uint32_t k = 0; k < info.inputs.size(); ++k) {
+                    for (auto arc : info.inputs[k].arcs) {
+                        for (const auto& var : compiled.inputArc(arc).tokenVariables()) {
+                            info.tokens[var.first].emplace_back(k, var.second);
+                        }
+                    }
+                }
+            }
+            for (const auto& arc : builder.getInhibitorArcs()) {
+                _info[arc.transition].inhibitors.emplace_back(arc.place, arc.weight);
+            }
+        }
+
+        void ColoredSuccessorGenerator::initialize(Structures::ColoredState& state) const {
+            state.places().clear();
+            for (const auto& place : _builder.getPlaces()) {
+                state.places().push_back(place.marking);
+            }
+        }
+
+        bool ColoredSuccessorGenerator::prepare(const Structures::State* state) {
+            _parent = static_cast<const Structures::ColoredState*>(state);
+            _transition = 0;
+            _binding = false;
+            return true;
+        }
+
+        bool ColoredSuccessorGenerator::next(Structures::State& write) {
+            for (; _transition < _compiled.size(); ++_transition) {
+                if (!_binding) {
+                    if (!firstBinding()) {
+                        continue;
+                    }
+                    _binding = true;
+                } else if (!nextBinding()) {
+                    _binding = false;
+                    continue;
+                }
+
+                do {
+                    bind();
+                    if (enabled()) {
+                        fire(static_cast<Structures::ColoredState&>(write));
+                        return true;
+                    }
+                } while (nextBinding());
+                _binding = false;
+            }
+            return false;
+        }
+
+        //Checks what does not depend on the binding
+        bool ColoredSuccessorGenerator::firstBinding() {
+            const auto& info = _info[_transition];
+            const MarkVal* marking = _parent->marking();
+            for (const auto& in : info.inputs) {
+                if (marking[_netPlaces[in.place]] < in.weight) {
+                    return false;
+                }
+            }
+            for (const auto& inhib : info.inhibitors) {
+                if (marking[_netPlaces[inhib.first]] >= inhib.second) {
+                    return false;
+                }
+            }
+
+            const auto& variables = _compiled[_transition].variables();
+            if (_candidates.size() < variables.size()) {
+                _candidates.resize(variables.size());
+            }
+            for (size_t i = 0; i < variables.size(); ++i) {
+                if (variables[i]->colorType->size() == 0) {
+                    return false;
+                }
+                if (!info.tokens[i].empty() && !tokenColors(info.inputs, info.tokens[i], _candidates[i])) {
+                    return false;
+                }
+            }
+            _colors.assign(variables.size(), 0);
+            if (_consumed.size() < info.inputs.size()) {
+                _consumed.resize(info.inputs.size());
+            }
+            return true;
+        }
+
+        //The colors a variable can have, taken from the place with the fewest distinct tokens
+        bool ColoredSuccessorGenerator::tokenColors(const std::vector<InputPlace>& inputs, const std::vector<TokenPosition>& tokens, std::vector<const Color*>& colors) const {
+            const TokenPosition* best = &tokens[0];
+            for (const auto& token : tokens) {
+                if (_parent->places()[inputs[token.first].place].distinctSize() < _parent->places()[inputs[best->first].place].distinctSize()) {
+                    best = &token;
+                }
+            }
+            colors.clear();
+            for (auto c : _parent->places()[inputs[best->first].place]) {
+                if (c.second == 0) {
+                    continue;
+                }
+                if (best->second < 0) {
+                    colors.push_back(c.first);
+                } else if ((size_t)best->second < c.first->getTupleColors().size()) {
+                    colors.push_back(c.first->getTupleColors()[best->second]);
+                }
+            }
+            if (best->second >= 0) {
+                std::sort(colors.begin(), colors.end(), [](const Color* a, const Color* b) {
+                    return a->getId() < b->getId();
+                });
+                colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
+            }
+            return !colors.empty();
+        }
+
+        bool ColoredSuccessorGenerator::nextBinding() {
+            const auto& variables = _compiled[_transition].variables();
+            const auto& tokens = _info[_transition].tokens;
+            for (size_t i = 0; i < _colors.size(); ++i) {
+                const size_t size = tokens[i].empty() ? variables[i]->colorType->size() : _candidates[i].size();
+                if (++_colors[i] < size) {
+                    return true;
+                }
+                _colors[i] = 0;
+            }
+            return false;
+        }
+
+        void ColoredSuccessorGenerator::bind() {
+            auto& compiled = _compiled[_transition];
+            const auto& variables = compiled.variables();
+            const auto& tokens = _info[_transition].tokens;
+            for (uint32_t i = 0; i < _colors.size(); ++i) {
+                if (tokens[i].empty()) {
+                    compiled.bind(i, &(*variables[i]->colorType)[(size_t)_colors[i]]);
+                } else {
+                    compiled.bind(i, _candidates[i][_colors[i]]);
+                }
+            }
+        }
+
+        bool ColoredSuccessorGenerator::enabled() {
+            auto& compiled = _compiled[_transition];
+            if (!compiled.evalGuard()) {
+                return false;
+            }
+
+            const auto& info = _info[_transition];
+            for (size_t k = 0; k < info.inputs.size(); ++k) {
+                const auto& in = info.inputs[k];
+                auto& consumed = _consumed[k];
+                consumed = compiled.evalInputArc(in.arcs[0], _noPartition);
+                for (size_t i = 1; i < in.arcs.size(); ++i) {
+                    consumed += compiled.evalInputArc(in.arcs[i], _noPartition);
+                }
+
+                if (!consumed.isSubsetOf(_parent->places()[in.place])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void ColoredSuccessorGenerator::fire(Structures::ColoredState& write) {
+            write.places() = _parent->places();
+            std::copy(_parent->marking(), _parent->marking() + _netPlaces.size(), write.marking());
+
+            const auto& info = _info[_transition];
+            for (size_t k = 0; k < info.inputs.size(); ++k) {
+                const auto place = info.inputs[k].place;
+                write.places()[place] -= _consumed[k];
+                write.places()[place].clean();
+                write.marking()[_netPlaces[place]] -= _consumed[k].size();
+            }
+
+            auto& compiled = _compiled[_transition];
+            const auto& outputs = _builder.getTransitions()[_transition].output_arcs;
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                const Multiset& produced = compiled.evalOutputArc(i, _noPartition);
+                write.places()[outputs[i].place] += produced;
+                write.marking()[_netPlaces[outputs[i].place]] += produced.size();
+            }
+        }
+    }
+}
@@ -172,21 +172,26 @@ namespace PetriEngine {
         }
 
         const Color& ProductType::operator[](size_t index) const {
-            if (_cache.count(index) < 1) {
-                size_t mod = 1;
-                size_t div = 1;
-
-                std::vector<const Color*> colors;
-                for (auto & constituent : _constituents) {
-                    mod = constituent->size();
-                    colors.push_back(&(*constituent)[(index / div) % mod]);
-                    div *= mod;
+            {
+                std::shared_lock<std::shared_mutex> lock(_cacheLock);
+                auto it = _cache.find(index);
+                if (it != _cache.end()) {
+                    return it->second;
                 }
-
-                _cache.emplace(index, Color(this, index, colors));
+            }
+            size_t mod = 1;
+            size_t div = 1;
+
+            std::vector<const Color*> colors;
+            for (auto & constituent : _constituents) {
+                mod = constituent->size();
+                colors.push_back(&(*constituent)[(index / div) % mod]);
+                div *= mod;
             }
 
-            return _cache.at(index);
+            // nodes of an unordered_map do not move, so the color stays valid after the lock is released
+            std::unique_lock<std::shared_mutex> lock(_cacheLock);
+            return _cache.emplace(index, Color(this, index, colors)).first->second;
         }
 
         const Color* ProductType::getColor(const std::vector<const Color*>& colors) const {
@@ -0,0 +1,354 @@
+/* Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "PetriEngine/Colored/CompiledExpression.h"
+#include "PetriEngine/Colored/ColoredNetStructures.h"
+
+namespace PetriEngine {
+    namespace Colored {
+        CompiledExpression ExpressionCompiler::compile(const GuardExpression& expr) {
+            CompiledExpression compiled;
+            _current = &compiled;
+            expr.compile(*this);
+            assert(_types.empty());
+            _current = nullptr;
+            return compiled;
+        }
+
+        CompiledExpression ExpressionCompiler::compile(const ArcExpression& expr) {
+            CompiledExpression compiled;
+            _current = &compiled;
+            _multisets = 1;
+            expr.compile(*this);
+            assert(_types.empty() && _multisets == 1);
+            _current = nullptr;
+            return compiled;
+        }
+
+        std::vector<std::pair<uint32_t, int32_t>> CompiledExpression::tokenVariables() const {
+            constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+            //The variable slot of each color on the color stack, or of each of its components if it is a tuple
+            struct Known {
+                bool tuple;
+                std::vector<uint32_t> slots;
+            };
+            std::vector<Known> colors;
+            std::vector<std::pair<uint32_t, int32_t>> res;
+            uint32_t multisets = 1;
+            for (const auto& instruction : _code) {
+                switch (instruction.op) {
+                    case ExpressionOp::Variable:
+                        colors.push_back({false, {instruction.arg}});
+                        break;
+                    case ExpressionOp::Color:
+                    case ExpressionOp::UserOperator:
+                        colors.push_back({false, {none}});
+                        break;
+                    case ExpressionOp::Successor:
+                    case ExpressionOp::Predecessor:
+                        colors.back() = {false, {none}};
+                        break;
+                    case ExpressionOp::Tuple: {
+                        Known tuple{true, {}};
+                        for (auto it = colors.end() - instruction.arg; it != colors.end(); ++it) {
+                            tuple.slots.push_back(it->tuple ? none : it->slots[0]);
+                        }
+                        colors.resize(colors.size() - instruction.arg);
+                        colors.push_back(std::move(tuple));
+                        break;
+                    }
+                    case ExpressionOp::AddColor: {
+                        const auto& top = colors.back();
+                        if (multisets == 1 && instruction.arg > 0) {
+                            for (size_t i = 0; i < top.slots.size(); ++i) {
+                                if (top.slots[i] != none) {
+                                    res.emplace_back(top.slots[i], top.tuple ? (int32_t)i : -1);
+                                }
+                            }
+                        }
+                        colors.pop_back();
+                        break;
+                    }
+                    case ExpressionOp::PushMultiset:
+                        ++multisets;
+                        break;
+                    case ExpressionOp::Subtract:
+                    case ExpressionOp::Merge:
+                        --multisets;
+                        break;
+                    default:
+                        break;
+                }
+            }
+            return res;
+        }
+
+        ExpressionInstruction& ExpressionCompiler::emit(ExpressionOp op, uint32_t arg) {
+            assert(_current != nullptr);
+            _current->_code.emplace_back();
+            auto& instruction = _current->_code.back();
+            instruction.op = op;
+            instruction.arg = arg;
+            instruction.color = nullptr;
+            return instruction;
+        }
+
+        void ExpressionCompiler::pushType(const ColorType* type) {
+            _types.push_back(type);
+            _current->_colorDepth = std::max<uint32_t>(_current->_colorDepth, _types.size());
+        }
+
+        uint32_t ExpressionCompiler::slot(const Variable* variable) {
+            auto it = std::find(_variables.begin(), _variables.end(), variable);
+            if (it != _variables.end()) {
+                return it - _variables.begin();
+            }
+            _variables.push_back(variable);
+            return _variables.size() - 1;
+        }
+
+        void ExpressionCompiler::pushColor(const Color* color) {
+            emit(ExpressionOp::Color).color = color;
+            pushType(color->getColorType());
+        }
+
+        void ExpressionCompiler::pushVariable(const Variable* variable) {
+            emit(ExpressionOp::Variable, slot(variable));
+            pushType(variable->colorType);
+        }
+
+        void ExpressionCompiler::pushUserOperator(const Color* color) {
+            emit(ExpressionOp::UserOperator).color = color;
+            pushType(color->getColorType());
+        }
+
+        void ExpressionCompiler::successor() {
+            emit(ExpressionOp::Successor);
+        }
+
+        void ExpressionCompiler::predecessor() {
+            emit(ExpressionOp::Predecessor);
+        }
+
+        void ExpressionCompiler::tuple(uint32_t size) {
+            assert(size <= _types.size());
+            //Same lookup as ExpressionContext::findProductColorType does on the evaluated colors
+            std::vector<const ColorType*> types(_types.end() - size, _types.end());
+            const ProductType* productType = nullptr;
+            for (auto& elem : _colorTypes) {
+                auto* pt = dynamic_cast<const ProductType*>(elem.second);
+                if (pt && pt->containsTypes(types)) {
+                    productType = pt;
+                    break;
+                }
+            }
+            assert(productType != nullptr);
+            emit(ExpressionOp::Tuple, size).productType = productType;
+            _types.resize(_types.size() - size);
+            pushType(productType);
+        }
+
+        void ExpressionCompiler::compare(ExpressionOp op) {
+            assert(_types.size() >= 2);
+            emit(op);
+            _types.resize(_types.size() - 2);
+        }
+
+        size_t ExpressionCompiler::jump(ExpressionOp op) {
+            emit(op);
+            return _current->_code.size() - 1;
+        }
+
+        void ExpressionCompiler::patch(size_t jump) {
+            _current->_code[jump].arg = _current->_code.size();
+        }
+
+        void ExpressionCompiler::addColor(uint32_t multiplicity) {
+            assert(!_types.empty());
+            emit(ExpressionOp::AddColor, multiplicity);
+            _types.pop_back();
+        }
+
+        void ExpressionCompiler::addAll(const ColorType* sort, uint32_t multiplicity) {
+            emit(ExpressionOp::AddAll, multiplicity).colorType = sort;
+        }
+
+        void ExpressionCompiler::pushMultiset() {
+            emit(ExpressionOp::PushMultiset);
+            ++_multisets;
+            _current->_multisetDepth = std::max(_current->_multisetDepth, _multisets);
+        }
+
+        void ExpressionCompiler::scale(uint32_t scalar) {
+            emit(ExpressionOp::Scale, scalar);
+        }
+
+        void ExpressionCompiler::subtract() {
+            assert(_multisets >= 2);
+            emit(ExpressionOp::Subtract);
+            --_multisets;
+        }
+
+        void ExpressionCompiler::merge() {
+            assert(_multisets >= 2);
+            emit(ExpressionOp::Merge);
+            --_multisets;
+        }
+
+        void ExpressionEvaluator::bind(const BindingMap& binding) {
+            for (size_t i = 0; i < _variables.size(); ++i) {
+                auto it = binding.find(_variables[i]);
+                _slots[i] = it != binding.end() ? it->second : nullptr;
+            }
+        }
+
+        bool ExpressionEvaluator::evalGuard(const CompiledExpression& expr) {
+            static const EquivalenceVec noPartition;
+            return run(expr, noPartition);
+        }
+
+        const Multiset& ExpressionEvaluator::evalArc(const CompiledExpression& expr, const EquivalenceVec& placePartition) {
+            if (_multisets.size() < expr._multisetDepth) {
+                _multisets.resize(expr._multisetDepth);
+            }
+            _top = 0;
+            _multisets[0].clear();
+            run(expr, placePartition);
+            assert(_top == 0);
+            return _multisets[0];
+        }
+
+        //Mirrors the eval methods of the expressions
+        bool ExpressionEvaluator::run(const CompiledExpression& expr, const EquivalenceVec& placePartition) {
+            _colors.reserve(expr._colorDepth);
+            bool result = true;
+            const auto& code = expr._code;
+            size_t pc = 0;
+            while (pc < code.size()) {
+                const ExpressionInstruction& instruction = code[pc++];
+                switch (instruction.op) {
+                    case ExpressionOp::Color:
+                        _colors.push_back(instruction.color);
+                        break;
+                    case ExpressionOp::Variable:
+                        _colors.push_back(_slots[instruction.arg]);
+                        break;
+                    case ExpressionOp::UserOperator:
+                        if (placePartition.getEquivalenceClasses().empty()) {
+                            _colors.push_back(instruction.color);
+                        } else {
+                            _tupleIds.clear();
+                            instruction.color->getTupleId(_tupleIds);
+                            placePartition.applyPartition(_tupleIds);
+                            _colors.push_back(instruction.color->getColorType()->getColor(_tupleIds));
+                        }
+                        break;
+                    case ExpressionOp::Successor:
+                        _colors.back() = &++(*_colors.back());
+                        break;
+                    case ExpressionOp::Predecessor:
+                        _colors.back() = &--(*_colors.back());
+                        break;
+                    case ExpressionOp::Tuple: {
+                        _tuple.assign(_colors.end() - instruction.arg, _colors.end());
+                        _colors.resize(_colors.size() - instruction.arg);
+                        const Color* color = instruction.productType->getColor(_tuple);
+                        assert(color != nullptr);
+                        _colors.push_back(color);
+                        break;
+                    }
+                    case ExpressionOp::LessThan:
+                    case ExpressionOp::GreaterThan:
+                    case ExpressionOp::LessThanEq:
+                    case ExpressionOp::GreaterThanEq:
+                    case ExpressionOp::Equal:
+                    case ExpressionOp::NotEqual: {
+                        const Color* right = _colors.back();
+                        _colors.pop_back();
+                        const Color* left = _colors.back();
+                        _colors.pop_back();
+                        switch (instruction.op) {
+                            case ExpressionOp::LessThan:      result = left < right; break;
+                            case ExpressionOp::GreaterThan:   result = left > right; break;
+                            case ExpressionOp::LessThanEq:    result = left <= right; break;
+                            case ExpressionOp::GreaterThanEq: result = left >= right; break;
+                            case ExpressionOp::Equal:         result = left == right; break;
+                            default:                          result = left != right; break;
+                        }
+                        break;
+                    }
+                    case ExpressionOp::JumpIfFalse:
+                        if (!result) pc = instruction.arg;
+                        break;
+                    case ExpressionOp::JumpIfTrue:
+                        if (result) pc = instruction.arg;
+                        break;
+                    case ExpressionOp::AddColor:
+                        _multisets[_top][_colors.back()] += instruction.arg;
+                        _colors.pop_back();
+                        break;
+                    case ExpressionOp::AddAll: {
+                        const ColorType* sort = instruction.colorType;
+                        Multiset& ms = _multisets[_top];
+                        if (placePartition.isDiagonal() || placePartition.getEquivalenceClasses().empty()) {
+                            for (size_t i = 0; i < sort->size(); i++) {
+                                ms[&(*sort)[i]] += instruction.arg;
+                            }
+                        } else {
+                            for (const auto& eq_class : placePartition.getEquivalenceClasses()) {
+                                ms[sort->getColor(eq_class.intervals().getLowerIds())] += eq_class.size() * instruction.arg;
+                            }
+                        }
+                        break;
+                    }
+                    case ExpressionOp::PushMultiset:
+                        _multisets[++_top].clear();
+                        break;
+                    case ExpressionOp::Scale:
+                        _multisets[_top] *= instruction.arg;
+                        break;
+                    case ExpressionOp::Subtract:
+                        --_top;
+                        _multisets[_top] -= _multisets[_top + 1];
+                        break;
+                    case ExpressionOp::Merge:
+                        --_top;
+                        _multisets[_top] += _multisets[_top + 1];
+                        break;
+                }
+            }
+            assert(_colors.empty());
+            return result;
+        }
+
+        CompiledTransition::CompiledTransition(const Transition& transition, const ColorTypeMap& colorTypes) {
+            ExpressionCompiler compiler(colorTypes);
+            if (transition.guard != nullptr) {
+                _guard = compiler.compile(*transition.guard);
+            }
+            for (const auto& arc : transition.input_arcs) {
+                _inputArcs.push_back(compiler.compile(*arc.expr));
+            }
+            for (const auto& arc : transition.output_arcs) {
+                _outputArcs.push_back(compiler.compile(*arc.expr));
+            }
+            _evaluator = ExpressionEvaluator(compiler.variables());
+        }
+    }
+}
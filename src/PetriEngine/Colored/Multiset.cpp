@@ -16,6 +16,8 @@
 
 #include <ios>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -23,23 +25,67 @@
 
 namespace PetriEngine {
     namespace Colored {
-        Multiset::Multiset() : _set(), _type(nullptr) {
+        Multiset::Multiset() : _type(nullptr) {
         }
 
-        Multiset::Multiset(const Multiset& orig) {
-            _set = orig._set;
-            _type = orig._type;
+        Multiset::Multiset(const Multiset& orig) : _type(orig._type) {
+            reserve(orig._size);
+            memcpy(data(), orig.data(), orig._size * sizeof(Entry));
+            _size = orig._size;
+        }
+
+        Multiset::Multiset(Multiset&& orig) noexcept : _size(orig._size), _capacity(orig._capacity), _type(orig._type) {
+            if (orig.onHeap()) {
+                _heap = orig._heap;
+            } else {
+                memcpy(_inline, orig._inline, orig._size * sizeof(Entry));
+            }
+            orig._size = 0;
+            orig._capacity = 0;
+        }
+
+        Multiset::Multiset(std::pair<const Color*,uint32_t> color) : _type(nullptr) {
+            (*this)[color.first] += color.second;
         }
 
         Multiset::Multiset(std::vector<std::pair<const Color*,uint32_t>>& colors)
-                : _set(), _type(nullptr)
+                : _type(nullptr)
         {
             for (auto& c : colors) {
                 (*this)[c.first] += c.second;
             }
         }
 
-        Multiset::~Multiset() = default;
+        Multiset::~Multiset() {
+            release();
+        }
+
+        Multiset& Multiset::operator=(const Multiset& other) {
+            if (&other != this) {
+                reserve(other._size);
+                memcpy(data(), other.data(), other._size * sizeof(Entry));
+                _size = other._size;
+                _type = other._type;
+            }
+            return *this;
+        }
+
+        Multiset& Multiset::operator=(Multiset&& other) noexcept {
+            if (&other != this) {
+                if (other.onHeap()) {
+                    release();
+                    _heap = other._heap;
+                    _capacity = other._capacity;
+                    other._capacity = 0;
+                } else {
+                    memcpy(data(), other._inline, other._size * sizeof(Entry));
+                }
+                _size = other._size;
+                _type = other._type;
+                other._size = 0;
+            }
+            return *this;
+        }
 
         Multiset Multiset::operator +(const Multiset& other) const {
             Multiset ms(*this);
@@ -66,12 +112,36 @@ namespace PetriEngine {
             if (other._type != nullptr && _type != other._type) {
                 throw "You cannot add Multisets over different sets";
             }
-            for (auto c : other._set) {
-                const Color* color = &(*ColorType::dotInstance()->begin());
-                if (_type != nullptr)
-                    color = &((*_type)[c.first]);
-                (*this)[color] += c.second;
+            if (&other == this) {
+                *this *= 2;
+                return;
             }
+
+            //Count the colors only in other, then merge from the back so no entry is moved twice
+            uint32_t added = 0;
+            const Entry* mine = data();
+            const Entry* theirs = other.data();
+            for (uint32_t i = 0, j = 0; j < other._size; ++j) {
+                while (i < _size && mine[i].id < theirs[j].id) ++i;
+                if (i == _size || mine[i].id != theirs[j].id) ++added;
+            }
+            reserve(_size + added);
+
+            Entry* entries = data();
+            int64_t i = (int64_t)_size - 1;
+            int64_t j = (int64_t)other._size - 1;
+            int64_t k = (int64_t)(_size + added) - 1;
+            while (j >= 0) {
+                if (i >= 0 && entries[i].id > theirs[j].id) {
+                    entries[k--] = entries[i--];
+                } else if (i >= 0 && entries[i].id == theirs[j].id) {
+                    entries[k] = entries[i--];
+                    entries[k--].count += theirs[j--].count;
+                } else {
+                    entries[k--] = theirs[j--];
+                }
+            }
+            _size += added;
         }
 
         void Multiset::operator -=(const Multiset& other) {
@@ -81,30 +151,29 @@ namespace PetriEngine {
             if (other._type != nullptr && _type != other._type) {
                 throw "You cannot add Multisets over different sets";
             }
-            for (auto c : _set) {
-                const Color* color = &(*ColorType::dotInstance()->begin());
-                if (_type != nullptr)
-                    color = &((*_type)[c.first]);
-                (*this)[color] = std::min(c.second - other[color], c.second);
+            //Colors are kept with no tokens left, a color cannot have fewer than none
+            Entry* mine = data();
+            const Entry* theirs = other.data();
+            for (uint32_t i = 0, j = 0; i < _size && j < other._size; ++i) {
+                while (j < other._size && theirs[j].id < mine[i].id) ++j;
+                if (j < other._size && theirs[j].id == mine[i].id) {
+                    mine[i].count -= std::min(mine[i].count, theirs[j].count);
+                }
             }
         }
 
         void Multiset::operator *=(uint32_t scalar) {
-            for (auto& c : _set) {
-                c.second *= scalar;
+            Entry* entries = data();
+            for (uint32_t i = 0; i < _size; ++i) {
+                entries[i].count *= scalar;
             }
         }
 
         uint32_t Multiset::operator [](const Color* color) const {
-            if (_type != nullptr && _type == color->getColorType()) {
-                for (auto c : _set) {
-                    if (c.first == color->getId())
-                        return c.second;
-                }
-            } else if (_type == nullptr){
-                for (auto c : _set) {
-                    if (c.first == color->getId())
-                        return c.second;
+            if (_type == nullptr || _type == color->getColorType()) {
+                const Entry* entry = find(color->getId());
+                if (entry != nullptr) {
+                    return entry->count;
                 }
             }
 
@@ -118,26 +187,83 @@ namespace PetriEngine {
             if (color->getColorType() != nullptr && _type != color->getColorType()) {
                 throw "You cannot access a Multiset with a color from a different color type";
             }
-            for (auto & i : _set) {
-                if (i.first == color->getId())
-                    return i.second;
+            const uint32_t id = color->getId();
+            Entry* entries = data();
+            Entry* pos = std::lower_bound(entries, entries + _size, id, [](const Entry& e, uint32_t id) {
+                return e.id < id;
+            });
+            if (pos != entries + _size && pos->id == id) {
+                return pos->count;
             }
 
-            _set.emplace_back(color->getId(), 0);
-            return _set.back().second;
+            const uint32_t index = pos - entries;
+            reserve(_size + 1);
+            entries = data();
+            memmove(&entries[index + 1], &entries[index], (_size - index) * sizeof(Entry));
+            entries[index] = Entry{id, 0};
+            ++_size;
+            return entries[index].count;
+        }
+
+        bool Multiset::isSubsetOf(const Multiset& other) const {
+            const Entry* mine = data();
+            const Entry* theirs = other.data();
+            uint32_t j = 0;
+            for (uint32_t i = 0; i < _size; ++i) {
+                if (mine[i].count == 0) continue;
+                while (j < other._size && theirs[j].id < mine[i].id) ++j;
+                if (j == other._size || theirs[j].id != mine[i].id || theirs[j].count < mine[i].count) {
+                    return false;
+                }
+            }
+            return true;
         }
 
         bool Multiset::empty() const {
-            return _set.empty();
+            return _size == 0;
         }
 
         void Multiset::clean() {
-            if (std::find_if(_set.begin(), _set.end(), [&](auto elem) { return elem.second == 0; }) == _set.end())
-                return;
+            Entry* entries = data();
+            _size = std::remove_if(entries, entries + _size, [](const Entry& e) {
+                return e.count == 0;
+            }) - entries;
+        }
 
-            _set.erase(std::remove_if(_set.begin(), _set.end(), [&](auto elem) {
-                return elem.second == 0;
-            }));
+        void Multiset::clear() {
+            _size = 0;
+            _type = nullptr;
+        }
+
+        const Multiset::Entry* Multiset::find(uint32_t id) const {
+            const Entry* entries = data();
+            const Entry* pos = std::lower_bound(entries, entries + _size, id, [](const Entry& e, uint32_t id) {
+                return e.id < id;
+            });
+            return pos != entries + _size && pos->id == id ? pos : nullptr;
+        }
+
+        const Color* Multiset::color(uint32_t id) const {
+            if (_type == nullptr)
+                return &(*ColorType::dotInstance()->begin());
+            return &(*_type)[id];
+        }
+
+        void Multiset::reserve(uint32_t size) {
+            if (size <= capacity()) return;
+            uint32_t ncap = std::max(capacity() * 2, size);
+            Entry* block = static_cast<Entry*>(malloc(ncap * sizeof(Entry)));
+            memcpy(block, data(), _size * sizeof(Entry));
+            release();
+            _heap = block;
+            _capacity = ncap;
+        }
+
+        void Multiset::release() {
+            if (onHeap()) {
+                free(_heap);
+                _capacity = 0;
+            }
         }
 
         const Multiset::Iterator Multiset::begin() const {
@@ -145,7 +271,7 @@ namespace PetriEngine {
         }
 
         const Multiset::Iterator Multiset::end() const{
-            return Iterator(this, _set.size());
+            return Iterator(this, _size);
         }
 
 
@@ -170,18 +296,16 @@ namespace PetriEngine {
         }
 
         std::pair<const Color *, const uint32_t &> Multiset::Iterator::operator*() {
-            auto& item = _ms->_set[_index];
-            auto color = &(*ColorType::dotInstance()->begin());
-            if (_ms->_type != nullptr)
-                color = &(*_ms->_type)[item.first];
-            return { color, item.second };
+            const auto& item = _ms->data()[_index];
+            return { _ms->color(item.id), item.count };
         }
 
         std::string Multiset::toString() const {
             std::ostringstream oss;
-            for (size_t i = 0; i < _set.size(); ++i) {
-                oss << _set[i].second << "'(" << (*_type)[_set[i].first].toString() << ")";
-                if (i < _set.size() - 1) {
+            const Entry* entries = data();
+            for (size_t i = 0; i < _size; ++i) {
+                oss << entries[i].count << "'(" << color(entries[i].id)->toString() << ")";
+                if (i < _size - 1) {
                     oss << " + ";
                 }
             }
@@ -191,11 +315,11 @@ namespace PetriEngine {
 
         size_t Multiset::size() const {
             size_t res = 0;
-            for (auto item : _set) {
-                res += item.second;
+            const Entry* entries = data();
+            for (uint32_t i = 0; i < _size; ++i) {
+                res += entries[i].count;
             }
             return res;
         }
     }
 }
-
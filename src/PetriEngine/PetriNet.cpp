@@ -47,6 +47,21 @@ namespace PetriEngine {
         delete[] _initialMarking;
     }
 
+    void PetriNet::nameTransitions() const {
+        size_t k = 0;
+        for(auto& block : _unnamedtransitions)
+        {
+            for(uint32_t i = 0; i < block.count; ++i, ++k)
+            {
+                _transitionnames[_unnamedids[k]] = block.prefix + "_" + std::to_string(i);
+            }
+        }
+        _unnamedtransitions.clear();
+        _unnamedtransitions.shrink_to_fit();
+        _unnamedids.clear();
+        _unnamedids.shrink_to_fit();
+    }
+
     int PetriNet::inArc(uint32_t place, uint32_t transition) const
     {
         assert(_nplaces > 0);
@@ -178,6 +193,7 @@ namespace PetriEngine {
     
     void PetriNet::toXML(std::ostream& out)
     {
+        auto& transitionnames = transitionNames();
         out << "<?xml version=\"1.0\"?>\n"
             << "<pnml xmlns=\"http://www.pnml.org/version-2009/grammar/pnml\">\n" 
             << "<net id=\"ClientsAndServers-PT-N0500P0\" type=\"http://www.pnml.org/version-2009/grammar/ptnet\">\n";
@@ -203,8 +219,8 @@ namespace PetriEngine {
         for(size_t i = 0; i < _ntransitions; ++i)
         {
             auto& transitionlocation = _transitionlocations[i];
-            out << "<transition id=\"" << _transitionnames[i] << "\">\n"
-                << "<name><text>" << _transitionnames[i] << "</text></name>\n";
+            out << "<transition id=\"" << transitionnames[i] << "\">\n"
+                << "<name><text>" << transitionnames[i] << "</text></name>\n";
             out << "<graphics><position x=\"" << std::get<0>(transitionlocation)
                 << "\" y=\"" << std::get<1>(transitionlocation) << "\"/></graphics>\n";
             out << "</transition>\n";
@@ -218,7 +234,7 @@ namespace PetriEngine {
             {
                 out << "<arc id=\"" << (id++) << "\" source=\""
                     << _placenames[pre.first->place] << "\" target=\""
-                    << _transitionnames[t]
+                    << transitionnames[t]
                     << "\" type=\""
                     << (pre.first->inhibitor ? "inhibitor" : "normal")
                     << "\">\n";
@@ -235,7 +251,7 @@ namespace PetriEngine {
             for(; post.first != post.second; ++post.first)
             {
                 out << "<arc id=\"" << (id++) << "\" source=\""
-                    << _transitionnames[t] << "\" target=\""
+                    << transitionnames[t] << "\" target=\""
                     << _placenames[post.first->place] << "\">\n";
                 
                 if(post.first->tokens > 1)
@@ -28,6 +28,8 @@
 #include "PetriEngine/PQL/Contexts.h"
 #include "PetriEngine/Reducer.h"
 #include "PetriEngine/PQL/Expressions.h"
+#include "PetriEngine/TAR/ContainsVisitor.h"
+#include "PetriEngine/errorcodes.h"
 
 
 namespace PetriEngine {
@@ -37,6 +39,7 @@ namespace PetriEngine {
     }
     PetriNetBuilder::PetriNetBuilder(const PetriNetBuilder& other)
     : _placenames(other._placenames), _transitionnames(other._transitionnames),
+       _unnamedtransitions(other._unnamedtransitions), _unnamedids(other._unnamedids),
        _placelocations(other._placelocations), _transitionlocations(other._transitionlocations),
        _transitions(other._transitions), _places(other._places), 
        initialMarking(other.initialMarking), reducer(this)
@@ -59,18 +62,66 @@ namespace PetriEngine {
         initialMarking[id] = tokens;        
     }
 
+    uint32_t PetriNetBuilder::addNewPlace(const std::string &name, int tokens, double x, double y) {
+        uint32_t id = _places.size();
+        auto res = _placenames.emplace(name, id);
+        if(!res.second)
+        {
+            std::cerr << "The place name " << name << " is already in use" << std::endl;
+            exit(ErrorCode);
+        }
+        _places.emplace_back();
+        _placelocations.push_back(std::tuple<double, double>(x,y));
+        initialMarking.resize(id + 1);
+        initialMarking[id] = tokens;
+        return id;
+    }
+
     void PetriNetBuilder::addTransition(const std::string &name,
             double x, double y) {
+        nameTransitions();
         if(_transitionnames.count(name) == 0)
         {
-            uint32_t next = _transitionnames.size();
+            uint32_t next = _transitions.size();
             _transitions.emplace_back();
             _transitionnames[name] = next;
             _transitionlocations.push_back(std::tuple<double, double>(x,y));
         }
     }
 
+    uint32_t PetriNetBuilder::addNewTransitions(const std::string &prefix, uint32_t count) {
+        uint32_t first = _transitions.size();
+        _transitions.resize(first + count);
+        _transitionlocations.resize(first + count, std::tuple<double, double>(0,0));
+        if(count > 0)
+            _unnamedtransitions.push_back(UnnamedTransitions{prefix, first, count});
+        return first;
+    }
+
+    void PetriNetBuilder::nameTransitions() {
+        if(_unnamedtransitions.empty()) return;
+        size_t count = _transitionnames.size();
+        for(auto& block : _unnamedtransitions)
+            count += block.count;
+        _transitionnames.reserve(count);
+        size_t k = 0;
+        for(auto& block : _unnamedtransitions)
+        {
+            for(uint32_t i = 0; i < block.count; ++i, ++k)
+            {
+                // after makePetriNet the names map to the ids of the net
+                uint32_t id = _unnamedids.empty() ? block.first + i : _unnamedids[k];
+                _transitionnames.emplace(block.prefix + "_" + std::to_string(i), id);
+            }
+        }
+        _unnamedtransitions.clear();
+        _unnamedtransitions.shrink_to_fit();
+        _unnamedids.clear();
+        _unnamedids.shrink_to_fit();
+    }
+
     void PetriNetBuilder::addInputArc(const std::string &place, const std::string &transition, bool inhibitor, int weight) {
+        nameTransitions();
         if(_transitionnames.count(transition) == 0)
         {
             addTransition(transition,0.0,0.0);
@@ -79,9 +130,10 @@ namespace PetriEngine {
         {
             addPlace(place,0,0,0);
         }
-        uint32_t p = _placenames[place];
-        uint32_t t = _transitionnames[transition];
+        addInputArc(_placenames[place], _transitionnames[transition], inhibitor, weight);
+    }
 
+    void PetriNetBuilder::addInputArc(uint32_t p, uint32_t t, bool inhibitor, int weight) {
         Arc arc;
         arc.place = p;
         arc.weight = weight;
@@ -96,6 +148,7 @@ namespace PetriEngine {
     }
 
     void PetriNetBuilder::addOutputArc(const std::string &transition, const std::string &place, int weight) {
+        nameTransitions();
         if(_transitionnames.count(transition) == 0)
         {
             addTransition(transition,0,0);
@@ -104,9 +157,10 @@ namespace PetriEngine {
         {
             addPlace(place,0,0,0);
         }
-        uint32_t p = _placenames[place];
-        uint32_t t = _transitionnames[transition];
+        addOutputArc(_transitionnames[transition], _placenames[place], weight);
+    }
 
+    void PetriNetBuilder::addOutputArc(uint32_t t, uint32_t p, int weight) {
         assert(t < _transitions.size());
         assert(p < _places.size());
         
@@ -363,8 +417,11 @@ namespace PetriEngine {
                 --rindex;
             }
         }
-        net->_transitionnames.resize(_transitionnames.size());
-        int trindex = _transitionnames.size() - 1;
+        size_t nunnamed = 0;
+        for(auto& block : _unnamedtransitions)
+            nunnamed += block.count;
+        net->_transitionnames.resize(_transitionnames.size() + nunnamed);
+        int trindex = _transitionnames.size() + nunnamed - 1;
         for(auto& i : _transitionnames)
         {
             auto& transitionlocation = _transitionlocations[i.second];
@@ -381,7 +438,26 @@ namespace PetriEngine {
                 --trindex;
             }
         }
+        // the unfolded transitions are named by the net when a name is needed
+        std::vector<uint32_t> unnamedids;
+        unnamedids.reserve(nunnamed);
+        for(auto& block : _unnamedtransitions)
+        {
+            for(uint32_t t = block.first; t < block.first + block.count; ++t)
+            {
+                uint32_t id = trans_idmap[t];
+                if(id == std::numeric_limits<uint32_t>::max())
+                    id = trindex--;
+                net->_transitionlocations[id] = _transitionlocations[t];
+                unnamedids.push_back(id);
+            }
+        }
+        net->_unnamedtransitions = _unnamedtransitions;
+        net->_unnamedids = unnamedids;
+        _unnamedids = std::move(unnamedids);
         net->sort();
+        net->_inhibitors = std::any_of(net->_invariants.begin(), net->_invariants.end(),
+                                       [](const Invariant& i) { return i.inhibitor; });
 
         for(size_t t = 0; t < net->numberOfTransitions(); ++t)
         {
@@ -448,11 +524,32 @@ namespace PetriEngine {
         }
     }
     
+    bool PetriNetBuilder::needsTransitionNames(const std::vector<std::shared_ptr<PQL::Condition> >& queries)
+    {
+        for(auto& q : queries)
+        {
+            ContainsVisitor<PQL::FireableCondition> fireable;
+            ContainsVisitor<PQL::UnfoldedFireableCondition> unfoldedfireable;
+            ContainsVisitor<PQL::LivenessCondition> liveness;
+            ContainsVisitor<PQL::QuasiLivenessCondition> quasiliveness;
+            q->visit(fireable);
+            q->visit(unfoldedfireable);
+            q->visit(liveness);
+            q->visit(quasiliveness);
+            if(fireable.does_contain() || unfoldedfireable.does_contain() ||
+               liveness.does_contain() || quasiliveness.does_contain())
+                return true;
+        }
+        return false;
+    }
+
     void PetriNetBuilder::reduce(   std::vector<std::shared_ptr<PQL::Condition> >& queries,
                                     std::vector<Reachability::ResultPrinter::Result>& results, 
                                     int reductiontype, bool reconstructTrace, const PetriNet* net, int timeout, std::vector<uint32_t>& reductions)
     {
-        QueryPlaceAnalysisContext placecontext(getPlaceNames(), getTransitionNames(), net);
+        // the reducer only names transitions it adds, the queries only need names if not compiled yet
+        static const std::unordered_map<std::string, uint32_t> nonames;
+        QueryPlaceAnalysisContext placecontext(getPlaceNames(), needsTransitionNames(queries) ? getTransitionNames() : nonames, net);
         bool all_reach = true;
         bool remove_loops = true;
         bool contains_next = false;
@@ -0,0 +1,306 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/Reachability/ExternalBFSSearch.h"
+#include "PetriEngine/PQL/Contexts.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <memory>
+#include <queue>
+#include <random>
+
+using namespace PetriEngine::PQL;
+using namespace PetriEngine::Structures;
+
+namespace PetriEngine {
+    namespace Reachability {
+
+        // number of runs merged at once, each open run buffers a block in memory
+        constexpr size_t MERGE_FANIN = 128;
+
+        ExternalBFSSearch::ExternalBFSSearch(PetriNet& net, AbstractHandler& callback, const std::string& directory,
+                                             size_t memory, int kbound)
+        : _net(net), _callback(callback), _directory(directory), _memory(std::max<size_t>(memory, 1)),
+          _kbound(kbound), _encoder(net.numberOfPlaces(), kbound)
+        {
+            _directory += "/verifypn-" + std::to_string(std::random_device()()) + "-";
+            _maxPlaceBound.resize(_net.numberOfPlaces(), 0);
+            _enabledTransitionsCount.resize(_net.numberOfTransitions(), 0);
+        }
+
+        ExternalBFSSearch::~ExternalBFSSearch()
+        {
+            for(auto& r : _runs)
+                removeRun(r);
+            removeRun(_layer);
+            removeRun(_visited);
+        }
+
+        std::string ExternalBFSSearch::newRun()
+        {
+            return _directory + std::to_string(_runid++) + ".run";
+        }
+
+        void ExternalBFSSearch::removeRun(const std::string& run)
+        {
+            if(!run.empty())
+                std::remove(run.c_str());
+        }
+
+        size_t ExternalBFSSearch::encode(const MarkVal* marking)
+        {
+            ++_discovered;
+            MarkVal sum = 0;
+            bool allsame = true;
+            uint32_t val = 0;
+            uint32_t active = 0;
+            for(uint32_t i = 0; i < _net.numberOfPlaces(); ++i)
+            {
+                if(marking[i] == 0) continue;
+                if(val != 0 && marking[i] != val) allsame = false;
+                val = std::max(marking[i], val);
+                ++active;
+                sum += marking[i];
+            }
+            _maxTokens = std::max(_maxTokens, sum);
+            if(_kbound != 0 && sum > (MarkVal)_kbound)
+                return 0;
+            for(uint32_t i = 0; i < _net.numberOfPlaces(); ++i)
+                _maxPlaceBound[i] = std::max(_maxPlaceBound[i], marking[i]);
+
+            auto length = _encoder.encode(marking, _encoder.getType(sum, active, allsame, val));
+            if(length >= std::numeric_limits<uint16_t>::max())
+            {
+                std::cerr << "error: Marking could not be encoded into less than 2^16 bytes" << std::endl;
+                std::exit(ErrorCode);
+            }
+            return length;
+        }
+
+        void ExternalBFSSearch::flushBuffer()
+        {
+            if(_buffer.empty()) return;
+            _runs.push_back(newRun());
+            RunWriter writer(_runs.back(), _io);
+            _buffer.write(writer);
+            _buffer.clear();
+        }
+
+        std::string ExternalBFSSearch::mergeRuns(std::vector<std::string>& runs, size_t from, size_t to)
+        {
+            std::vector<std::unique_ptr<RunReader>> readers;
+            for(size_t i = from; i < to; ++i)
+                readers.emplace_back(std::make_unique<RunReader>(runs[i], _io));
+            auto greater = [&](size_t a, size_t b) {
+                return compareRecords(readers[a]->data(), readers[a]->length(),
+                                      readers[b]->data(), readers[b]->length()) > 0;
+            };
+            std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+            for(size_t i = 0; i < readers.size(); ++i)
+                if(readers[i]->next()) heap.push(i);
+
+            auto out = newRun();
+            {
+                RunWriter writer(out, _io);
+                std::vector<unsigned char> last;
+                uint16_t lastlen = 0;
+                bool first = true;
+                while(!heap.empty())
+                {
+                    auto i = heap.top();
+                    heap.pop();
+                    auto& r = *readers[i];
+                    if(first || compareRecords(last.data(), lastlen, r.data(), r.length()) != 0)
+                    {
+                        writer.write(r.data(), r.length());
+                        last.assign(r.data(), r.data() + r.length());
+                        lastlen = r.length();
+                        first = false;
+                    }
+                    if(r.next()) heap.push(i);
+                }
+            }
+            readers.clear();
+            for(size_t i = from; i < to; ++i)
+                removeRun(runs[i]);
+            return out;
+        }
+
+        size_t ExternalBFSSearch::mergeLayer(std::vector<std::string>& runs)
+        {
+            // bound the number of open runs by merging in several passes
+            while(runs.size() >= MERGE_FANIN)
+            {
+                std::vector<std::string> merged;
+                for(size_t i = 0; i < runs.size(); i += MERGE_FANIN)
+                    merged.push_back(mergeRuns(runs, i, std::min(runs.size(), i + MERGE_FANIN)));
+                runs.swap(merged);
+            }
+
+            std::vector<std::unique_ptr<RunReader>> readers;
+            for(auto& r : runs)
+                readers.emplace_back(std::make_unique<RunReader>(r, _io));
+            // the visited states are the last source
+            const size_t visited = readers.size();
+            readers.emplace_back(std::make_unique<RunReader>(_visited, _io));
+
+            auto greater = [&](size_t a, size_t b) {
+                return compareRecords(readers[a]->data(), readers[a]->length(),
+                                      readers[b]->data(), readers[b]->length()) > 0;
+            };
+            std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+            for(size_t i = 0; i < readers.size(); ++i)
+                if(readers[i]->next()) heap.push(i);
+
+            size_t count = 0;
+            auto layer = newRun();
+            auto allvisited = newRun();
+            {
+                RunWriter lwriter(layer, _io);
+                RunWriter vwriter(allvisited, _io);
+                std::vector<unsigned char> current;
+                while(!heap.empty())
+                {
+                    auto i = heap.top();
+                    heap.pop();
+                    uint16_t length = readers[i]->length();
+                    current.assign(readers[i]->data(), readers[i]->data() + length);
+                    bool old = i == visited;
+                    if(readers[i]->next()) heap.push(i);
+                    // all copies of the record are at the top of the heap
+                    while(!heap.empty())
+                    {
+                        auto j = heap.top();
+                        if(compareRecords(current.data(), length, readers[j]->data(), readers[j]->length()) != 0)
+                            break;
+                        heap.pop();
+                        old |= j == visited;
+                        if(readers[j]->next()) heap.push(j);
+                    }
+                    vwriter.write(current.data(), length);
+                    if(!old)
+                    {
+                        lwriter.write(current.data(), length);
+                        ++count;
+                    }
+                }
+            }
+            readers.clear();
+            for(auto& r : runs)
+                removeRun(r);
+            runs.clear();
+            removeRun(_layer);
+            removeRun(_visited);
+            _layer = layer;
+            _visited = allvisited;
+            return count;
+        }
+
+        bool ExternalBFSSearch::checkQueries(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                                             std::vector<ResultPrinter::Result>& results,
+                                             State& state)
+        {
+            if(!_usequeries) return false;
+
+            bool alldone = true;
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                if(results[i] == ResultPrinter::Unknown)
+                {
+                    EvaluationContext ec(state.marking(), &_net);
+                    if(queries[i]->evaluate(ec) == Condition::RTRUE)
+                    {
+                        auto r = doCallback(queries[i], i, ResultPrinter::Satisfied);
+                        results[i] = r.first;
+                        if(r.second)
+                            return true;
+                    }
+                    else
+                    {
+                        alldone = false;
+                    }
+                }
+            }
+            return alldone;
+        }
+
+        std::pair<ResultPrinter::Result,bool> ExternalBFSSearch::doCallback(std::shared_ptr<PQL::Condition>& query, size_t i,
+                                                                             ResultPrinter::Result r)
+        {
+            return _callback.handle(i, query.get(), r, &_maxPlaceBound,
+                        _expanded, _explored, _discovered, _maxTokens,
+                        nullptr, 0, _initial.marking());
+        }
+
+        void ExternalBFSSearch::printStats()
+        {
+            auto mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+            std::cout   << "STATS:\n"
+                        << "\tdiscovered states: " << _discovered << std::endl
+                        << "\texplored states:   " << _explored << std::endl
+                        << "\texpanded states:   " << _expanded << std::endl
+                        << "\tmax tokens:        " << _maxTokens << std::endl
+                        << "\tBFS layers:        " << _layers << std::endl
+                        << std::fixed << std::setprecision(1)
+                        << "\tdisk written (MB): " << mb(_io.bytesWritten) << std::endl
+                        << "\tdisk read (MB):    " << mb(_io.bytesRead) << std::endl
+                        << "\tI/O time (s):      " << _io.seconds << std::endl
+                        << "\tI/O (MB/s):        "
+                        << (_io.seconds > 0 ? mb(_io.bytesWritten + _io.bytesRead) / _io.seconds : 0) << std::endl;
+            std::cout << std::defaultfloat;
+
+            std::cout << "\nTRANSITION STATISTICS\n";
+            for (size_t i = 0; i < _net.numberOfTransitions(); ++i) {
+                std::cout << "<" << _net.transitionNames()[i] << ":"
+                        << _enabledTransitionsCount[i] << ">";
+            }
+            // report how many times transitions were enabled (? means that the transition was removed in net reduction)
+            for(size_t i = _net.numberOfTransitions(); i < _net.transitionNames().size(); ++i)
+            {
+                std::cout << "<" << _net.transitionNames()[i] << ":?>";
+            }
+
+            std::cout << "\n\nPLACE-BOUND STATISTICS\n";
+            for (size_t i = 0; i < _net.numberOfPlaces(); ++i)
+            {
+                std::cout << "<" << _net.placeNames()[i] << ";" << _maxPlaceBound[i] << ">";
+            }
+
+            // report maximum bounds for each place (? means that the place was removed in net reduction)
+            for(size_t i = _net.numberOfPlaces(); i < _net.placeNames().size(); ++i)
+            {
+                std::cout << "<" << _net.placeNames()[i] << ";?>";
+            }
+
+            std::cout << std::endl << std::endl;
+        }
+
+        bool ExternalBFSSearch::reachable(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                                          std::vector<ResultPrinter::Result>& results,
+                                          bool usestubborn,
+                                          bool statespacesearch,
+                                          bool printstats)
+        {
+            _usequeries = !statespacesearch;
+            if(usestubborn && _usequeries)
+                return tryReach<ReducingSuccessorGenerator>(queries, results, printstats);
+            else
+                return tryReach<SuccessorGenerator>(queries, results, printstats);
+        }
+    }
+}
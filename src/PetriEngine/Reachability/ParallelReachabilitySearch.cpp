@@ -0,0 +1,272 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "PetriEngine/Reachability/ParallelReachabilitySearch.h"
+#include "PetriEngine/PQL/Contexts.h"
+
+#include <algorithm>
+
+using namespace PetriEngine::PQL;
+using namespace PetriEngine::Structures;
+
+namespace PetriEngine {
+    namespace Reachability {
+
+        WorkQueue::WorkQueue(Strategy strategy, size_t seed)
+        : _strategy(strategy)
+        {
+            _rng.seed(seed);
+        }
+
+        void WorkQueue::flushCache()
+        {
+            if(_cache.empty()) return;
+            std::shuffle(_cache.begin(), _cache.end(), _rng);
+            _deque.insert(_deque.end(), _cache.begin(), _cache.end());
+            _cache.clear();
+        }
+
+        void WorkQueue::push(size_t id, uint32_t weight)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            switch(_strategy)
+            {
+                case HEUR:
+                    _heap.emplace(weight, id);
+                    break;
+                case RDFS:
+                    _cache.push_back(id);
+                    break;
+                default:
+                    _deque.push_back(id);
+                    break;
+            }
+        }
+
+        bool WorkQueue::pop(size_t& id)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            if(_strategy == HEUR)
+            {
+                if(_heap.empty()) return false;
+                id = _heap.top().item;
+                _heap.pop();
+                return true;
+            }
+            flushCache();
+            if(_deque.empty()) return false;
+            if(_strategy == BFS)
+            {
+                id = _deque.front();
+                _deque.pop_front();
+            }
+            else
+            {
+                id = _deque.back();
+                _deque.pop_back();
+            }
+            return true;
+        }
+
+        bool WorkQueue::steal(size_t& id)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            if(_strategy == HEUR)
+            {
+                if(_heap.empty()) return false;
+                id = _heap.top().item;
+                _heap.pop();
+                return true;
+            }
+            flushCache();
+            if(_deque.empty()) return false;
+            // take the oldest state for depth-first orders as it is likely
+            // to have the largest unexplored subtree
+            if(_strategy == BFS)
+            {
+                id = _deque.back();
+                _deque.pop_back();
+            }
+            else
+            {
+                id = _deque.front();
+                _deque.pop_front();
+            }
+            return true;
+        }
+
+        bool ParallelReachabilitySearch::findWork(size_t tid, size_t& id)
+        {
+            if(_queues[tid]->pop(id))
+                return true;
+            ++_idle;
+            while(!_done)
+            {
+                // nobody is working, so nobody can produce new states
+                if(_idle == _threads)
+                    return false;
+                --_idle;
+                for(size_t i = 1; i < _threads; ++i)
+                {
+                    if(_queues[(tid + i) % _threads]->steal(id))
+                        return true;
+                }
+                ++_idle;
+                std::this_thread::yield();
+            }
+            return false;
+        }
+
+        uint32_t ParallelReachabilitySearch::weight(State& state, const Condition_ptr& query)
+        {
+            if(_strategy != HEUR) return 0;
+            DistanceContext dc(&_net, state.marking());
+            return query->distance(dc);
+        }
+
+        bool ParallelReachabilitySearch::checkQueries(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                                                      std::vector<ResultPrinter::Result>& results,
+                                                      State& state, workerstate_t& ws)
+        {
+            if(!_usequeries) return false;
+
+            bool alldone = true;
+            EvaluationContext ec(state.marking(), &_net);
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                if(_solved[i]) continue;
+                Condition::Result r;
+                if(_serialeval)
+                {
+                    // upper-bounds queries record the bound while evaluating
+                    std::lock_guard<std::mutex> lock(_query_lock);
+                    r = queries[i]->evaluate(ec);
+                }
+                else
+                {
+                    r = queries[i]->evaluate(ec);
+                }
+                if(r == Condition::RTRUE)
+                    handle(queries, results, i, ResultPrinter::Satisfied);
+                else
+                    alldone = false;
+            }
+
+            if(queries.size() >= 2 && _solved[ws.heurquery])
+            {
+                for(size_t n = 1; n < queries.size(); ++n)
+                {
+                    auto q = (ws.heurquery + n) % queries.size();
+                    if(!_solved[q])
+                    {
+                        ws.heurquery = q;
+                        break;
+                    }
+                }
+            }
+            return alldone || _done;
+        }
+
+        void ParallelReachabilitySearch::handle(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                                                std::vector<ResultPrinter::Result>& results,
+                                                size_t i, ResultPrinter::Result r)
+        {
+            std::lock_guard<std::mutex> lock(_result_lock);
+            if(_solved[i]) return;
+            auto bounds = _states->maxPlaceBound();
+            auto res = _callback.handle(i, queries[i].get(), r, &bounds,
+                        _expandedStates, _exploredStates, _states->discovered(), _states->maxTokens(),
+                        nullptr, 0, _net.initial());
+            results[i] = res.first;
+            _solved[i] = true;
+            if(res.second)
+                _done = true;
+        }
+
+        void ParallelReachabilitySearch::printStats(std::vector<workerstate_t>& ws)
+        {
+            std::vector<size_t> enabled(_net.numberOfTransitions(), 0);
+            for(auto& w : ws)
+                for(size_t t = 0; t < enabled.size(); ++t)
+                    enabled[t] += w.enabledTransitionsCount[t];
+            auto bounds = _states->maxPlaceBound();
+
+            std::cout   << "STATS:\n"
+                        << "\tdiscovered states: " << _states->discovered() << std::endl
+                        << "\texplored states:   " << _exploredStates << std::endl
+                        << "\texpanded states:   " << _expandedStates << std::endl
+                        << "\tmax tokens:        " << _states->maxTokens() << std::endl
+                        << "\tthreads:           " << _threads << std::endl;
+
+            std::cout << "\nTRANSITION STATISTICS\n";
+            for (size_t i = 0; i < _net.numberOfTransitions(); ++i) {
+                std::cout << "<" << _net.transitionNames()[i] << ":"
+                        << enabled[i] << ">";
+            }
+            // report how many times transitions were enabled (? means that the transition was removed in net reduction)
+            for(size_t i = _net.numberOfTransitions(); i < _net.transitionNames().size(); ++i)
+            {
+                std::cout << "<" << _net.transitionNames()[i] << ":?>";
+            }
+
+            std::cout << "\n\nPLACE-BOUND STATISTICS\n";
+            for (size_t i = 0; i < _net.numberOfPlaces(); ++i)
+            {
+                std::cout << "<" << _net.placeNames()[i] << ";" << bounds[i] << ">";
+            }
+
+            // report maximum bounds for each place (? means that the place was removed in net reduction)
+            for(size_t i = _net.numberOfPlaces(); i < _net.placeNames().size(); ++i)
+            {
+                std::cout << "<" << _net.placeNames()[i] << ";?>";
+            }
+
+            std::cout << std::endl << std::endl;
+        }
+
+        bool ParallelReachabilitySearch::reachable(
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    std::vector<ResultPrinter::Result>& results,
+                    Strategy strategy,
+                    bool stubbornreduction,
+                    bool statespacesearch,
+                    bool printstats,
+                    size_t seed)
+        {
+            bool usequeries = !statespacesearch;
+
+            // if we are searching for bounds
+            if(!usequeries) strategy = BFS;
+
+            switch(strategy)
+            {
+                case DFS:
+                case BFS:
+                case HEUR:
+                case RDFS:
+                    if(stubbornreduction)
+                        return tryReach<ReducingSuccessorGenerator>(queries, results, strategy, usequeries, printstats, seed);
+                    else if(_vectorized)
+                        return tryReach<VectorizedSuccessorGenerator>(queries, results, strategy, usequeries, printstats, seed);
+                    else
+                        return tryReach<SuccessorGenerator>(queries, results, strategy, usequeries, printstats, seed);
+                default:
+                    std::cerr << "UNSUPPORTED SEARCH STRATEGY" << std::endl;
+                    exit(ErrorCode);
+            }
+        }
+    }
+}
@@ -116,8 +116,11 @@ namespace PetriEngine {
         
 #define TRYREACHPAR    (queries, results, usequeries, printstats, seed)
 #define TEMPPAR(X, Y)  if(keep_trace) return tryReach<X, Structures::TracableStateSet, Y>TRYREACHPAR ; \
+                       else if(_bitstate_bits > 0) return tryReach<X, Structures::BitStateSet, Y> TRYREACHPAR; \
                        else return tryReach<X, Structures::StateSet, Y> TRYREACHPAR;
-#define TRYREACH(X)    if(stubbornreduction) TEMPPAR(X, ReducingSuccessorGenerator) \
+#define TRYREACH(X)    if(_colored != nullptr) return tryReach<X, Structures::ColoredStateSet, Colored::ColoredSuccessorGenerator, Structures::ColoredState> TRYREACHPAR; \
+                       else if(stubbornreduction) TEMPPAR(X, ReducingSuccessorGenerator) \
+                       else if(_vectorized) TEMPPAR(X, VectorizedSuccessorGenerator) \
                        else TEMPPAR(X, SuccessorGenerator)
         
 
@@ -150,6 +153,15 @@ namespace PetriEngine {
                 case RDFS:
                     TRYREACH(RDFSQueue)
                     break;
+                case ASTAR:
+                    TRYREACH(AStarQueue)
+                    break;
+                case BEAM:
+                    TRYREACH(BeamQueue)
+                    break;
+                case RESTART:
+                    TRYREACH(RandomRestartQueue)
+                    break;
                 default:
                     std::cerr << "UNSUPPORTED SEARCH STRATEGY" << std::endl;
                     exit(ErrorCode);
@@ -41,6 +41,15 @@ namespace PetriEngine {
                     return std::make_pair(Ignore,false);
                 }
             }
+            if(result == NotSatisfied && stateset != nullptr && !stateset->complete() &&
+               !options->statespaceexploration)
+            {
+                // no witness was found, but the bitstate or beam search may have pruned it
+                std::cout << "\nUnable to decide if " << querynames[index] << " is satisfied.\n\n";
+                std::cout << "Query is MAYBE satisfied.\n";
+                std::cout << "The search is possibly incomplete (bitstate hashing or beam search).\n" << std::endl;
+                return std::make_pair(Ignore,false);
+            }
             std::cout << std::endl;    
             
             bool showTrace = (result == Satisfied);
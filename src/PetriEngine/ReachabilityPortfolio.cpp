@@ -0,0 +1,199 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/ReachabilityPortfolio.h"
+#include "PetriEngine/Reachability/ReachabilitySearch.h"
+#include "PetriEngine/TAR/TARReachability.h"
+#include "PetriEngine/STSolver.h"
+#include "PetriEngine/PQL/Expressions.h"
+
+#include <thread>
+
+using namespace PetriEngine::PQL;
+using namespace PetriEngine::Reachability;
+
+namespace PetriEngine {
+
+    std::pair<AbstractHandler::Result, bool> ReachabilityPortfolio::handler_t::handle(
+                size_t index,
+                PQL::Condition* query,
+                Result result,
+                const std::vector<uint32_t>* maxPlaceBound,
+                size_t expandedStates,
+                size_t exploredStates,
+                size_t discoveredStates,
+                int maxTokens,
+                Structures::StateSetInterface* stateset, size_t lastmarking, const MarkVal* initialMarking)
+    {
+        // only definite answers are reported, another engine may still succeed
+        if(result != Satisfied && result != NotSatisfied)
+            return std::make_pair(Unknown, false);
+
+        std::lock_guard<std::mutex> lock(_portfolio._result_lock);
+        if(_portfolio._answered[index])
+            return std::make_pair(_portfolio._results[index], _portfolio._stop.load());
+
+        auto r = _portfolio._printer.handle(index, query, result, maxPlaceBound,
+                    expandedStates, exploredStates, discoveredStates, maxTokens,
+                    stateset, lastmarking, initialMarking);
+        if(_portfolio._options.printstatistics)
+            std::cout << "Query index " << index << " was answered by the " << name(_member) << " engine of the portfolio\n" << std::endl;
+        _portfolio._results[index] = r.first;
+        _portfolio._answered[index] = true;
+        --_portfolio._remaining;
+        if(_portfolio._remaining == 0 || r.second)
+            _portfolio._stop = true;
+        return std::make_pair(r.first, _portfolio._stop.load());
+    }
+
+    bool ReachabilityPortfolio::supports(const std::vector<Condition_ptr>& queries)
+    {
+        for(auto& q : queries)
+            if(q->getQuantifier() == Quantifier::UPPERBOUNDS)
+                return false;
+        return true;
+    }
+
+    const char* ReachabilityPortfolio::name(member_t member)
+    {
+        switch(member)
+        {
+            case HEUR: return "heuristic search";
+            case RDFS: return "random depth-first search";
+            case BFS: return "breadth-first search";
+            case DFS: return "depth-first search";
+            case TAR: return "trace abstraction refinement";
+            case SIPHON_TRAP: return "siphon-trap";
+        }
+        return "unknown";
+    }
+
+    std::vector<ReachabilityPortfolio::member_t> ReachabilityPortfolio::members(const std::vector<Condition_ptr>& queries, const std::vector<Result>& results) const
+    {
+        std::vector<member_t> members{HEUR};
+
+        if(_options.siphontrapTimeout > 0)
+        {
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                if(results[i] == AbstractHandler::Unknown && dynamic_cast<DeadlockCondition*>(queries[i].get()) != nullptr)
+                {
+                    members.push_back(SIPHON_TRAP);
+                    break;
+                }
+            }
+        }
+
+        // inhibitors are not supported by the TAR engine
+        bool tar = _net.numberOfPlaces() > 0;
+        for(size_t t = 0; tar && t < _net.numberOfTransitions(); ++t)
+        {
+            auto in = _net.preset(t);
+            for(; in.first != in.second; ++in.first)
+            {
+                if(in.first->inhibitor)
+                {
+                    tar = false;
+                    break;
+                }
+            }
+        }
+        if(tar) members.push_back(TAR);
+
+        members.push_back(RDFS);
+        members.push_back(BFS);
+        members.push_back(DFS);
+
+        if(members.size() > _options.cores)
+            members.resize(std::max<uint32_t>(_options.cores, 1));
+        return members;
+    }
+
+    void ReachabilityPortfolio::run(member_t member, std::vector<Condition_ptr>& queries, std::vector<Result> results)
+    {
+        handler_t handler(*this, member);
+        switch(member)
+        {
+            case TAR:
+            {
+                TARReachabilitySearch search(handler, _net, _reducer, _options.kbound);
+                search.setQueryLock(&_query_lock);
+                search.setStopFlag(&_stop);
+                search.reachable(queries, results, false, false);
+                break;
+            }
+            case SIPHON_TRAP:
+            {
+                for(size_t i = 0; i < queries.size() && !_stop; ++i)
+                {
+                    if(results[i] != AbstractHandler::Unknown || dynamic_cast<DeadlockCondition*>(queries[i].get()) == nullptr)
+                        continue;
+                    STSolver solver(handler, _net, queries[i].get(), _options.siphonDepth);
+                    solver.setStopFlag(&_stop);
+                    solver.solve(_options.siphontrapTimeout);
+                    solver.printResult(i);
+                }
+                break;
+            }
+            default:
+            {
+                Strategy strategy = Reachability::HEUR;
+                switch(member)
+                {
+                    case RDFS: strategy = Reachability::RDFS; break;
+                    case BFS: strategy = Reachability::BFS; break;
+                    case DFS: strategy = Reachability::DFS; break;
+                    default: break;
+                }
+                ReachabilitySearch search(_net, handler, _options.kbound);
+                search.setQueryLock(&_query_lock);
+                search.setStopFlag(&_stop);
+                size_t seed;
+                {
+                    std::lock_guard<std::mutex> lock(_result_lock);
+                    seed = _options.seed();
+                }
+                search.reachable(queries, results, strategy,
+                                 _options.stubbornreduction, false, false, false, seed);
+                break;
+            }
+        }
+    }
+
+    void ReachabilityPortfolio::reachable(std::vector<Condition_ptr>& queries, std::vector<Result>& results)
+    {
+        _results = results;
+        _answered.assign(queries.size(), false);
+        _remaining = 0;
+        for(size_t i = 0; i < queries.size(); ++i)
+        {
+            _answered[i] = results[i] != AbstractHandler::Unknown;
+            if(!_answered[i]) ++_remaining;
+        }
+        _stop = _remaining == 0;
+        if(_stop) return;
+
+        auto ms = members(queries, results);
+        std::vector<std::thread> threads;
+        for(auto m : ms)
+            threads.emplace_back([this, m, &queries, &results]() { run(m, queries, results); });
+        for(auto& t : threads)
+            t.join();
+
+        results = _results;
+    }
+}
@@ -62,6 +62,8 @@ namespace PetriEngine {
 
     std::string Reducer::getTransitionName(uint32_t transition)
     {
+        // only used when reconstructing traces, so the unfolded transitions are named here
+        parent->nameTransitions();
         for(auto t : parent->_transitionnames)
         {
             if(t.second == transition) return t.first;
@@ -74,6 +76,7 @@ namespace PetriEngine {
     {
         auto prefix = "CT";
         auto tmp = prefix + std::to_string(_tnameid);
+        parent->nameTransitions();
         while(parent->_transitionnames.count(tmp) >= 1)
         {
             ++_tnameid;
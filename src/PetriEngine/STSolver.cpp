@@ -4,7 +4,7 @@
 
 namespace PetriEngine {     
     
-    STSolver::STSolver(Reachability::ResultPrinter& printer, const PetriNet& net, PQL::Condition * query, uint32_t depth) : printer(printer), _query(query), _net(net){
+    STSolver::STSolver(Reachability::AbstractHandler& printer, const PetriNet& net, PQL::Condition * query, uint32_t depth) : printer(printer), _query(query), _net(net){
         if(depth == 0){
             _siphonDepth = _net._nplaces;
         } else {
@@ -55,7 +55,7 @@ namespace PetriEngine {
             extend(p, preset, postset);
             if(!siphonTrap(siphon, has_st, preset, postset))
             {
-                if(timeout())
+                if(timeout() && (_stop == nullptr || !_stop->load()))
                 {
                     std::cout << "TIMEOUT OF SIPHON" << std::endl;
                 }
@@ -203,14 +203,16 @@ namespace PetriEngine {
         return true;
     }
     
-    Reachability::ResultPrinter::Result STSolver::printResult(){
+    Reachability::ResultPrinter::Result STSolver::printResult(size_t index){
         if(_siphonPropperty){
-            return printer.handle(0, _query, Reachability::ResultPrinter::NotSatisfied).first;
+            return printer.handle(index, _query, Reachability::ResultPrinter::NotSatisfied).first;
         } else {
             return Reachability::ResultPrinter::Unknown;
         }
     }
     bool STSolver::timeout() const {
+        if(_stop != nullptr && _stop->load(std::memory_order_relaxed))
+            return true;
         return (duration() >= _timelimit);
     }
     uint32_t STSolver::duration() const {
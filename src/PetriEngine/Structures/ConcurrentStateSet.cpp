@@ -0,0 +1,143 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/Structures/ConcurrentStateSet.h"
+#include "PetriEngine/Simplification/MurmurHash2.h"
+
+#include <iostream>
+#include <limits>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        ConcurrentStateSet::thread_t::thread_t(uint32_t nplaces, uint32_t kbound)
+        : _encoder(nplaces, kbound), _discovered(0), _maxTokens(0),
+          _maxPlaceBound(std::make_unique<std::atomic<MarkVal>[]>(nplaces))
+        {
+            for(uint32_t p = 0; p < nplaces; ++p)
+                _maxPlaceBound[p] = 0;
+        }
+
+        ConcurrentStateSet::ConcurrentStateSet(const PetriNet& net, uint32_t kbound, uint32_t shards, uint32_t threads)
+        : _net(net), _kbound(kbound)
+        {
+            shards = std::max<uint32_t>(shards, 1);
+            threads = std::max<uint32_t>(threads, 1);
+            for(uint32_t i = 0; i < shards; ++i)
+                _shards.emplace_back(std::make_unique<shard_t>());
+            for(uint32_t i = 0; i < threads; ++i)
+                _threads.emplace_back(std::make_unique<thread_t>(net.numberOfPlaces(), kbound));
+        }
+
+        std::pair<bool, size_t> ConcurrentStateSet::add(const State& state, size_t tid)
+        {
+            auto& ctx = *_threads[tid];
+            ctx._discovered.store(ctx._discovered.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            const auto nplaces = _net.numberOfPlaces();
+            auto marking = state.marking();
+            MarkVal sum = 0;
+            bool allsame = true;
+            uint32_t val = 0;
+            uint32_t active = 0;
+            for(uint32_t i = 0; i < nplaces; ++i)
+            {
+                if(marking[i] == 0) continue;
+                if(val != 0 && marking[i] != val) allsame = false;
+                val = std::max(marking[i], val);
+                ++active;
+                sum += marking[i];
+            }
+
+            if(ctx._maxTokens.load(std::memory_order_relaxed) < sum)
+                ctx._maxTokens.store(sum, std::memory_order_relaxed);
+
+            //Check that we're within k-bound
+            if(_kbound != 0 && sum > _kbound)
+                return std::pair<bool, size_t>(false, std::numeric_limits<size_t>::max());
+
+            // encode outside of the lock, in the scratchpad of this thread
+            auto type = ctx._encoder.getType(sum, active, allsame, val);
+            size_t length = ctx._encoder.encode(marking, type);
+            if(length*8 >= std::numeric_limits<uint16_t>::max())
+            {
+                std::cerr << "error: Marking could not be encoded into less than 2^16 bytes, current limit of PTries" << std::endl;
+                std::exit(-1);
+            }
+            auto raw = ctx._encoder.scratchpad().const_raw();
+
+            size_t sid = 0;
+            if(_shards.size() > 1)
+                sid = MurmurHash64A(raw, length, 0) % _shards.size();
+            auto& shard = *_shards[sid];
+            std::pair<bool, size_t> res;
+            {
+                std::lock_guard<std::mutex> lock(shard._lock);
+                res = shard._trie.insert(raw, length);
+            }
+            res.second = (res.second * _shards.size()) + sid;
+            if(!res.first)
+                return res;
+
+            // update the max token bound for each place in the net (only for newly discovered markings)
+            for(uint32_t i = 0; i < nplaces; ++i)
+            {
+                if(ctx._maxPlaceBound[i].load(std::memory_order_relaxed) < marking[i])
+                    ctx._maxPlaceBound[i].store(marking[i], std::memory_order_relaxed);
+            }
+            return res;
+        }
+
+        void ConcurrentStateSet::decode(State& state, size_t id, size_t tid)
+        {
+            auto& ctx = *_threads[tid];
+            auto& shard = *_shards[id % _shards.size()];
+            {
+                std::lock_guard<std::mutex> lock(shard._lock);
+                shard._trie.unpack(id / _shards.size(), ctx._encoder.scratchpad().raw());
+            }
+            ctx._encoder.decode(state.marking(), ctx._encoder.scratchpad().raw());
+        }
+
+        size_t ConcurrentStateSet::discovered() const
+        {
+            size_t sum = 0;
+            for(auto& t : _threads)
+                sum += t->_discovered.load(std::memory_order_relaxed);
+            return sum;
+        }
+
+        uint32_t ConcurrentStateSet::maxTokens() const
+        {
+            uint32_t m = 0;
+            for(auto& t : _threads)
+                m = std::max(m, t->_maxTokens.load(std::memory_order_relaxed));
+            return m;
+        }
+
+        std::vector<MarkVal> ConcurrentStateSet::maxPlaceBound() const
+        {
+            std::vector<MarkVal> bounds(_net.numberOfPlaces(), 0);
+            for(auto& t : _threads)
+            {
+                for(size_t p = 0; p < bounds.size(); ++p)
+                    bounds[p] = std::max(bounds[p], t->_maxPlaceBound[p].load(std::memory_order_relaxed));
+            }
+            return bounds;
+        }
+    }
+}
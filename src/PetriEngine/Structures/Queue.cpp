@@ -19,6 +19,7 @@
 #include "PetriEngine/PQL/Contexts.h"
 
 #include <algorithm>
+#include <limits>
 #include <random>
 
 namespace PetriEngine {
@@ -37,6 +38,7 @@ namespace PetriEngine {
             if(_cnt < _nstates)
             {
                 _states->decode(state, _cnt);
+                _states->release(_cnt);
                 ++_cnt;
                 return true;
             }
@@ -62,6 +64,7 @@ namespace PetriEngine {
             uint32_t n = _stack.top();
             _stack.pop();
             _states->decode(state, n);
+            _states->release(n);
             return true;
         }
         
@@ -93,6 +96,7 @@ namespace PetriEngine {
                 uint32_t n = _stack.top();
                 _stack.pop();
                 _states->decode(state, n);
+                _states->release(n);
                 return true;                
             }
             else
@@ -100,6 +104,7 @@ namespace PetriEngine {
                 std::shuffle ( _cache.begin(), _cache.end(), _rng );
 		uint32_t n = _cache.back();
                 _states->decode(state, n);
+                _states->release(n);
                 for(size_t i = 0; i < (_cache.size() - 1); ++i)
                 {
                     _stack.push(_cache[i]);
@@ -141,6 +146,7 @@ namespace PetriEngine {
             uint32_t n = _queue.top().item;
             _queue.pop();
             _states->decode(state, n);
+            _states->release(n);
             return true;
         }
         
@@ -152,5 +158,99 @@ namespace PetriEngine {
             _queue.emplace(dist, (uint32_t)id);
         }
 
+        AStarQueue::AStarQueue(StateSetInterface* states, size_t) : Queue(states) {}
+        AStarQueue::~AStarQueue(){}
+
+        bool AStarQueue::pop(Structures::State& state)
+        {
+            if(_queue.empty()) return false;
+            uint32_t n = _queue.top().item;
+            _depth = _queue.top().depth;
+            _queue.pop();
+            _states->decode(state, n);
+            _states->release(n);
+            return true;
+        }
+
+        void AStarQueue::push(size_t id, PQL::DistanceContext& context,
+            std::shared_ptr<PQL::Condition>& query)
+        {
+            uint32_t dist = query->distance(context);
+            uint32_t depth = _depth + 1;
+            // the distance may be close to the max of uint32_t, so the cost saturates
+            uint32_t cost = std::min<uint64_t>((uint64_t)depth + dist, std::numeric_limits<uint32_t>::max());
+            _queue.emplace(cost, dist, depth, (uint32_t)id);
+        }
+
+        BeamQueue::BeamQueue(StateSetInterface* states, size_t, size_t width)
+        : Queue(states), _width(std::max<size_t>(width, 1)) {}
+        BeamQueue::~BeamQueue(){}
+
+        bool BeamQueue::pop(Structures::State& state)
+        {
+            if(_queue.empty()) return false;
+            auto best = std::prev(_queue.end());
+            uint32_t n = best->item;
+            _queue.erase(best);
+            _states->decode(state, n);
+            _states->release(n);
+            return true;
+        }
+
+        void BeamQueue::push(size_t id, PQL::DistanceContext& context,
+            std::shared_ptr<PQL::Condition>& query)
+        {
+            uint32_t dist = query->distance(context);
+            _queue.emplace(dist, (uint32_t)id);
+            if(_queue.size() > _width)
+            {
+                auto worst = _queue.begin();
+                _states->release(worst->item);
+                _queue.erase(worst);
+                _states->setPruned();
+            }
+        }
+
+        RandomRestartQueue::RandomRestartQueue(StateSetInterface* states, size_t seed, size_t interval)
+        : Queue(states), _interval(interval)
+        {
+            _rng.seed(seed);
+        }
+
+        RandomRestartQueue::~RandomRestartQueue(){}
+
+        bool RandomRestartQueue::pop(Structures::State& state)
+        {
+            if(_heap.empty()) return false;
+            uint32_t n;
+            if(_interval > 0 && ++_pops % _interval == 0 && _heap.size() > 1)
+            {
+                ++_epoch;
+                std::uniform_int_distribution<size_t> dist(0, _heap.size() - 1);
+                auto i = dist(_rng);
+                n = _heap[i].item;
+                _heap[i] = _heap.back();
+                _heap.pop_back();
+                std::make_heap(_heap.begin(), _heap.end());
+            }
+            else
+            {
+                std::pop_heap(_heap.begin(), _heap.end());
+                n = _heap.back().item;
+                _heap.pop_back();
+            }
+            _states->decode(state, n);
+            _states->release(n);
+            return true;
+        }
+
+        void RandomRestartQueue::push(size_t id, PQL::DistanceContext& context,
+            std::shared_ptr<PQL::Condition>& query)
+        {
+            uint32_t dist = query->distance(context);
+            _heap.emplace_back(_epoch, dist, (uint32_t)id);
+            std::push_heap(_heap.begin(), _heap.end());
+        }
+
     }
 }
@@ -0,0 +1,179 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/Structures/RunFile.h"
+#include "PetriEngine/errorcodes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        constexpr size_t RUN_BLOCK_SIZE = 1 << 18;
+
+        static double since(std::chrono::high_resolution_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        int compareRecords(const unsigned char* a, uint16_t alen, const unsigned char* b, uint16_t blen)
+        {
+            if(alen != blen) return alen < blen ? -1 : 1;
+            return memcmp(a, b, alen);
+        }
+
+        RunWriter::RunWriter(const std::string& path, io_stats_t& stats)
+        : _stats(stats)
+        {
+            _file = fopen(path.c_str(), "wb");
+            if(_file == nullptr)
+            {
+                std::cerr << "error: Could not open " << path << " for writing" << std::endl;
+                std::exit(ErrorCode);
+            }
+            _buffer.reserve(RUN_BLOCK_SIZE);
+        }
+
+        RunWriter::~RunWriter()
+        {
+            close();
+        }
+
+        void RunWriter::write(const unsigned char* data, uint16_t length)
+        {
+            if(_buffer.size() + length + sizeof(uint16_t) > RUN_BLOCK_SIZE)
+                flush();
+            auto l = reinterpret_cast<const unsigned char*>(&length);
+            _buffer.insert(_buffer.end(), l, l + sizeof(uint16_t));
+            _buffer.insert(_buffer.end(), data, data + length);
+            ++_records;
+        }
+
+        void RunWriter::flush()
+        {
+            if(_buffer.empty()) return;
+            auto start = std::chrono::high_resolution_clock::now();
+            if(fwrite(_buffer.data(), 1, _buffer.size(), _file) != _buffer.size())
+            {
+                std::cerr << "error: Could not write state file, is the disk full?" << std::endl;
+                std::exit(ErrorCode);
+            }
+            _stats.seconds += since(start);
+            _stats.bytesWritten += _buffer.size();
+            _buffer.clear();
+        }
+
+        void RunWriter::close()
+        {
+            if(_file == nullptr) return;
+            flush();
+            fclose(_file);
+            _file = nullptr;
+        }
+
+        RunReader::RunReader(const std::string& path, io_stats_t& stats)
+        : _stats(stats), _buffer(RUN_BLOCK_SIZE), _record(std::numeric_limits<uint16_t>::max())
+        {
+            _file = fopen(path.c_str(), "rb");
+            if(_file == nullptr)
+            {
+                std::cerr << "error: Could not open " << path << " for reading" << std::endl;
+                std::exit(ErrorCode);
+            }
+        }
+
+        RunReader::~RunReader()
+        {
+            if(_file != nullptr)
+                fclose(_file);
+        }
+
+        bool RunReader::fill()
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            _end = fread(_buffer.data(), 1, _buffer.size(), _file);
+            _stats.seconds += since(start);
+            _stats.bytesRead += _end;
+            _pos = 0;
+            return _end > 0;
+        }
+
+        bool RunReader::read(unsigned char* dest, size_t n)
+        {
+            while(n > 0)
+            {
+                if(_pos == _end && !fill())
+                    return false;
+                auto chunk = std::min(n, _end - _pos);
+                memcpy(dest, &_buffer[_pos], chunk);
+                _pos += chunk;
+                dest += chunk;
+                n -= chunk;
+            }
+            return true;
+        }
+
+        bool RunReader::next()
+        {
+            if(!read(reinterpret_cast<unsigned char*>(&_length), sizeof(uint16_t)))
+                return false;
+            return read(_record.data(), _length);
+        }
+
+        void RunBuffer::add(const unsigned char* data, uint16_t length)
+        {
+            _offsets.push_back(_data.size());
+            auto l = reinterpret_cast<const unsigned char*>(&length);
+            _data.insert(_data.end(), l, l + sizeof(uint16_t));
+            _data.insert(_data.end(), data, data + length);
+        }
+
+        void RunBuffer::write(RunWriter& writer)
+        {
+            auto length = [this](size_t off) {
+                uint16_t l;
+                memcpy(&l, &_data[off], sizeof(uint16_t));
+                return l;
+            };
+            auto record = [this](size_t off) { return &_data[off + sizeof(uint16_t)]; };
+            std::sort(_offsets.begin(), _offsets.end(), [&](size_t a, size_t b) {
+                return compareRecords(record(a), length(a), record(b), length(b)) < 0;
+            });
+            for(size_t i = 0; i < _offsets.size(); ++i)
+            {
+                auto off = _offsets[i];
+                if(i > 0)
+                {
+                    auto prev = _offsets[i - 1];
+                    if(compareRecords(record(prev), length(prev), record(off), length(off)) == 0)
+                        continue;
+                }
+                writer.write(record(off), length(off));
+            }
+        }
+
+        void RunBuffer::clear()
+        {
+            _data.clear();
+            _offsets.clear();
+        }
+    }
+}
@@ -31,11 +31,16 @@ namespace PetriEngine {
             return true;
         }
         assert(!_queries.empty());
-        for (auto &q : _queries) {
-            q->evalAndSet(PQL::EvaluationContext((*_parent).marking(), &_net));
+        {
+            std::unique_lock<std::mutex> lock;
+            if (_query_lock != nullptr)
+                lock = std::unique_lock<std::mutex>(*_query_lock);
+            for (auto &q : _queries) {
+                q->evalAndSet(PQL::EvaluationContext((*_parent).marking(), &_net));
 
-            assert(_interesting->get_negated() == false);
-            q->visit(*_interesting);
+                assert(_interesting->get_negated() == false);
+                q->visit(*_interesting);
+            }
         }
 
         closure();
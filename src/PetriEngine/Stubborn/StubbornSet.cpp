@@ -35,20 +35,29 @@ namespace PetriEngine {
     }
 
     bool StubbornSet::checkPreset(uint32_t t) {
+        return _netContainsInhibitorArcs ? checkPresetImpl<true>(t) : checkPresetImpl<false>(t);
+    }
+
+    template <bool Inhibitors>
+    bool StubbornSet::checkPresetImpl(uint32_t t) {
         const TransPtr &ptr = transitions()[t];
         uint32_t finv = ptr.inputs;
         uint32_t linv = ptr.outputs;
 
         for (; finv < linv; ++finv) {
             const Invariant &inv = _net._invariants[finv];
-            if (_parent->marking()[inv.place] < inv.tokens) {
-                if (!inv.inhibitor) {
-                    return false;
-                }
-            } else {
-                if (inv.inhibitor) {
-                    return false;
+            if constexpr (Inhibitors) {
+                if (_parent->marking()[inv.place] < inv.tokens) {
+                    if (!inv.inhibitor) {
+                        return false;
+                    }
+                } else {
+                    if (inv.inhibitor) {
+                        return false;
+                    }
                 }
+            } else if (_parent->marking()[inv.place] < inv.tokens) {
+                return false;
             }
         }
         return true;
@@ -105,8 +114,24 @@ namespace PetriEngine {
 
     void StubbornSet::constructEnabled() {
         _ordering.clear();
-        memset(_enabled.get(), 0, _net.numberOfTransitions());
         memset(_stubborn.get(), 0, _net.numberOfTransitions());
+        if (_incremental) {
+            _incremental->update(_parent->marking());
+            auto enabled = _incremental->enabled();
+            for (uint32_t t = 0; t < _net.numberOfTransitions(); ++t) {
+                _enabled[t] = enabled[t];
+                if (enabled[t]) _ordering.push_back(t);
+            }
+            _nenabled += _incremental->nenabled();
+            return;
+        }
+        memset(_enabled.get(), 0, _net.numberOfTransitions());
+        if (_netContainsInhibitorArcs) addEnabled<true>();
+        else addEnabled<false>();
+    }
+
+    template <bool Inhibitors>
+    void StubbornSet::addEnabled() {
         for (uint32_t p = 0; p < _net.numberOfPlaces(); ++p) {
             // orphans are currently under "place 0" as a special case
             if (p == 0 || _parent->marking()[p] > 0) {
@@ -114,7 +139,7 @@ namespace PetriEngine {
                 uint32_t last = placeToPtrs()[p + 1];
 
                 for (; t != last; ++t) {
-                    if (!checkPreset(t)) {
+                    if (!checkPresetImpl<Inhibitors>(t)) {
                         continue;
                     }
                     _enabled[t] = true;
@@ -35,21 +35,34 @@ namespace PetriEngine {
     bool SuccessorGenerator::prepare(const Structures::State* state) {
         _parent = state;
         reset();
+        if(_incremental)
+            _incremental->update(state->marking());
         return true;
     }
 
+    void SuccessorGenerator::setIncremental(bool incremental) {
+        if(!incremental) _incremental = nullptr;
+        else if(!_incremental) _incremental = std::make_unique<IncrementalEnabledSet>(_net);
+    }
+
     void SuccessorGenerator::reset() {
         _suc_pcounter = 0;
         _suc_tcounter = std::numeric_limits<uint32_t>::max();
     }
 
     void SuccessorGenerator::consumePreset(Structures::State& write, uint32_t t) {
+        if (_net._inhibitors) consumePresetImpl<true>(write, t);
+        else consumePresetImpl<false>(write, t);
+    }
+
+    template<bool Inhibitors>
+    void SuccessorGenerator::consumePresetImpl(Structures::State& write, uint32_t t) {
 
         const TransPtr& ptr = _net._transitions[t];
         uint32_t finv = ptr.inputs;
         uint32_t linv = ptr.outputs;
         for (; finv < linv; ++finv) {
-            if(!_net._invariants[finv].inhibitor) {
+            if(!Inhibitors || !_net._invariants[finv].inhibitor) {
                 assert(write.marking()[_net._invariants[finv].place] >= _net._invariants[finv].tokens);
                 write.marking()[_net._invariants[finv].place] -= _net._invariants[finv].tokens;
             }
@@ -57,20 +70,29 @@ namespace PetriEngine {
     }
 
     bool SuccessorGenerator::checkPreset(uint32_t t) {
+        return _net._inhibitors ? checkPresetImpl<true>(t) : checkPresetImpl<false>(t);
+    }
+
+    template<bool Inhibitors>
+    bool SuccessorGenerator::checkPresetImpl(uint32_t t) {
         const TransPtr& ptr = _net._transitions[t];
         uint32_t finv = ptr.inputs;
         uint32_t linv = ptr.outputs;
 
         for (; finv < linv; ++finv) {
             const Invariant& inv = _net._invariants[finv];
-            if ((*_parent).marking()[inv.place] < inv.tokens) {
-                if (!inv.inhibitor) {
-                    return false;
-                }
-            } else {
-                if (inv.inhibitor) {
-                    return false;
+            if constexpr (Inhibitors) {
+                if ((*_parent).marking()[inv.place] < inv.tokens) {
+                    if (!inv.inhibitor) {
+                        return false;
+                    }
+                } else {
+                    if (inv.inhibitor) {
+                        return false;
+                    }
                 }
+            } else if ((*_parent).marking()[inv.place] < inv.tokens) {
+                return false;
             }
         }
         return true;
@@ -93,6 +115,12 @@ namespace PetriEngine {
     }
 
     bool SuccessorGenerator::next(Structures::State& write) {
+        if (_incremental) return nextIncremental(write);
+        return _net._inhibitors ? nextImpl<true>(write) : nextImpl<false>(write);
+    }
+
+    template<bool Inhibitors>
+    bool SuccessorGenerator::nextImpl(Structures::State& write) {
         for (; _suc_pcounter < _net._nplaces; ++_suc_pcounter) {
             // orphans are currently under "place 0" as a special case
             if (_suc_pcounter == 0 || (*_parent).marking()[_suc_pcounter] > 0) {
@@ -102,9 +130,9 @@ namespace PetriEngine {
                 uint32_t last = _net._placeToPtrs[_suc_pcounter + 1];
                 for (; _suc_tcounter != last; ++_suc_tcounter) {
 
-                    if (!checkPreset(_suc_tcounter)) continue;
+                    if (!checkPresetImpl<Inhibitors>(_suc_tcounter)) continue;
                     memcpy(write.marking(), (*_parent).marking(), _net._nplaces * sizeof (MarkVal));
-                    consumePreset(write, _suc_tcounter);
+                    consumePresetImpl<Inhibitors>(write, _suc_tcounter);
                     producePostset(write, _suc_tcounter);
 
                     ++_suc_tcounter;
@@ -117,6 +145,22 @@ namespace PetriEngine {
         return false;
     }
 
+    bool SuccessorGenerator::nextIncremental(Structures::State& write) {
+        // _suc_pcounter only marks that all successors have been generated
+        if (_suc_pcounter == _net._nplaces) return false;
+        const uint8_t* enabled = _incremental->enabled();
+        uint32_t t = _suc_tcounter == std::numeric_limits<uint32_t>::max() ? 0 : _suc_tcounter;
+        for (; t < _net._ntransitions; ++t) {
+            if (!enabled[t]) continue;
+            _fire(write, t);
+            _suc_tcounter = t + 1;
+            return true;
+        }
+        _suc_pcounter = _net._nplaces;
+        _suc_tcounter = std::numeric_limits<uint32_t>::max();
+        return false;
+    }
+
     bool SuccessorGenerator::next(Structures::State& write, uint32_t &tindex) {
         _parent = &write;
         _suc_pcounter = 0;
@@ -119,6 +119,8 @@ namespace PetriEngine {
             }
             while (!waiting.empty()) 
             {
+                if(stopped())
+                    return std::make_pair(true, false);
                 if(popDone(waiting, _stepno)) 
                     continue;  // we have reached the end of the edge-iterator for this part of the trace
 
@@ -162,7 +164,14 @@ namespace PetriEngine {
                     stopwatch ct;
                     ct.start();
 #endif
-                    auto satisfied = solver.check(waiting, _traceset);
+                    bool satisfied;
+                    {
+                        // the solver annotates the query while checking the trace
+                        std::unique_lock<std::mutex> lock;
+                        if(_query_lock != nullptr)
+                            lock = std::unique_lock<std::mutex>(*_query_lock);
+                        satisfied = solver.check(waiting, _traceset);
+                    }
 #ifdef TAR_TIMING
                     ct.stop();
                     _check_time += ct.duration();
@@ -252,6 +261,7 @@ namespace PetriEngine {
                 {
                     if(!satisfied)
                     {
+                        if(stopped()) return false;
                         if(update_use(false)) continue;
 #ifdef VERBOSETAR
                         for(size_t t = 0; t < _net.numberOfTransitions(); ++t)
@@ -495,6 +505,8 @@ namespace PetriEngine {
                     }
                     Solver solver(_net, state.marking(), queries[i].get(), used);
                     bool res = tryReach(printtrace, solver);
+                    if(stopped())
+                        return;
                     if(res)
                         results[i] = ResultPrinter::Satisfied;
                     else
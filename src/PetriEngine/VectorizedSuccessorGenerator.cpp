@@ -0,0 +1,223 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2026  agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/VectorizedSuccessorGenerator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VERIFYPN_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace PetriEngine {
+
+    using block_check_t = VectorizedSuccessorGenerator::block_check_t;
+    constexpr uint32_t LANES = VectorizedSuccessorGenerator::LANES;
+
+    // returns a bit per lane, set if all arcs of the lane are satisfied
+    static uint32_t checkScalar(const MarkVal* marking, const uint32_t* places,
+                                const uint32_t* tokens, const uint32_t* inhibitor, uint32_t arcs)
+    {
+        uint32_t mask = (1 << LANES) - 1;
+        for(uint32_t k = 0; k < arcs && mask != 0; ++k)
+        {
+            for(uint32_t l = 0; l < LANES; ++l)
+            {
+                auto i = k * LANES + l;
+                bool covered = marking[places[i]] >= tokens[i];
+                if(covered == (inhibitor[i] != 0))
+                    mask &= ~(1 << l);
+            }
+        }
+        return mask;
+    }
+
+#ifdef VERIFYPN_X86_DISPATCH
+    __attribute__((target("avx2")))
+    static uint32_t checkAVX2(const MarkVal* marking, const uint32_t* places,
+                              const uint32_t* tokens, const uint32_t* inhibitor, uint32_t arcs)
+    {
+        __m256i ok = _mm256_set1_epi32(-1);
+        for(uint32_t k = 0; k < arcs; ++k)
+        {
+            auto offset = k * LANES;
+            auto p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(places + offset));
+            auto m = _mm256_i32gather_epi32(reinterpret_cast<const int*>(marking), p, sizeof(MarkVal));
+            auto t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tokens + offset));
+            auto inhib = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inhibitor + offset));
+            // unsigned m >= t
+            auto covered = _mm256_cmpeq_epi32(_mm256_max_epu32(m, t), m);
+            ok = _mm256_and_si256(ok, _mm256_xor_si256(covered, inhib));
+            if(_mm256_testz_si256(ok, ok))
+                return 0;
+        }
+        return _mm256_movemask_ps(_mm256_castsi256_ps(ok));
+    }
+
+    __attribute__((target("sse4.1")))
+    static uint32_t checkSSE41(const MarkVal* marking, const uint32_t* places,
+                               const uint32_t* tokens, const uint32_t* inhibitor, uint32_t arcs)
+    {
+        __m128i ok[2] = {_mm_set1_epi32(-1), _mm_set1_epi32(-1)};
+        for(uint32_t k = 0; k < arcs; ++k)
+        {
+            for(uint32_t h = 0; h < 2; ++h)
+            {
+                auto offset = k * LANES + h * 4;
+                // no gather in SSE
+                auto m = _mm_set_epi32(marking[places[offset + 3]], marking[places[offset + 2]],
+                                       marking[places[offset + 1]], marking[places[offset]]);
+                auto t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tokens + offset));
+                auto inhib = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inhibitor + offset));
+                auto covered = _mm_cmpeq_epi32(_mm_max_epu32(m, t), m);
+                ok[h] = _mm_and_si128(ok[h], _mm_xor_si128(covered, inhib));
+            }
+            if(_mm_testz_si128(ok[0], ok[0]) && _mm_testz_si128(ok[1], ok[1]))
+                return 0;
+        }
+        return _mm_movemask_ps(_mm_castsi128_ps(ok[0])) |
+              (_mm_movemask_ps(_mm_castsi128_ps(ok[1])) << 4);
+    }
+#endif
+
+    static block_check_t selectCheck()
+    {
+#ifdef VERIFYPN_X86_DISPATCH
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            return checkAVX2;
+        if(__builtin_cpu_supports("sse4.1"))
+            return checkSSE41;
+#endif
+        return checkScalar;
+    }
+
+    static block_check_t selectedCheck()
+    {
+        static const block_check_t check = selectCheck();
+        return check;
+    }
+
+    const char* VectorizedSuccessorGenerator::implementation()
+    {
+#ifdef VERIFYPN_X86_DISPATCH
+        if(selectedCheck() == checkAVX2) return "AVX2";
+        if(selectedCheck() == checkSSE41) return "SSE4.1";
+#endif
+        return "scalar";
+    }
+
+    VectorizedSuccessorGenerator::VectorizedSuccessorGenerator(const PetriNet& net)
+    : SuccessorGenerator(net), _check(selectedCheck())
+    {
+        const uint32_t nblocks = (net._ntransitions + LANES - 1) / LANES;
+        _blockArcs.resize(nblocks + 1, 0);
+        _enabled.resize(nblocks, 0);
+        for(uint32_t b = 0; b < nblocks; ++b)
+        {
+            uint32_t arcs = 0;
+            for(uint32_t t = b * LANES; t < std::min((b + 1) * LANES, net._ntransitions); ++t)
+                arcs = std::max(arcs, net._transitions[t].outputs - net._transitions[t].inputs);
+            _blockArcs[b + 1] = _blockArcs[b] + arcs;
+        }
+        // padding arcs from place 0 requiring no tokens are always satisfied
+        _places.resize(_blockArcs.back() * LANES, 0);
+        _tokens.resize(_blockArcs.back() * LANES, 0);
+        _inhibitor.resize(_blockArcs.back() * LANES, 0);
+        for(uint32_t t = 0; t < net._ntransitions; ++t)
+        {
+            auto b = t / LANES;
+            auto l = t % LANES;
+            const TransPtr& ptr = net._transitions[t];
+            for(uint32_t k = 0; k < ptr.outputs - ptr.inputs; ++k)
+            {
+                const Invariant& inv = net._invariants[ptr.inputs + k];
+                auto i = (_blockArcs[b] + k) * LANES + l;
+                _places[i] = inv.place;
+                _tokens[i] = inv.tokens;
+                _inhibitor[i] = inv.inhibitor ? std::numeric_limits<uint32_t>::max() : 0;
+            }
+        }
+    }
+
+    VectorizedSuccessorGenerator::VectorizedSuccessorGenerator(const PetriNet& net, std::vector<std::shared_ptr<PQL::Condition> >& queries)
+    : VectorizedSuccessorGenerator(net) {}
+
+    VectorizedSuccessorGenerator::VectorizedSuccessorGenerator(const PetriNet& net, const std::shared_ptr<PQL::Condition>& query)
+    : VectorizedSuccessorGenerator(net) {}
+
+    bool VectorizedSuccessorGenerator::prepare(const Structures::State* state)
+    {
+        SuccessorGenerator::prepare(state);
+        const auto marking = state->marking();
+        const uint32_t nblocks = _enabled.size();
+        // transitions are grouped by a place they consume from, so only the
+        // groups of marked places (and the orphans of place 0) can be enabled.
+        uint32_t done = 0;
+        for(uint32_t p = 0; p < _net._nplaces; ++p)
+        {
+            if(p != 0 && marking[p] == 0) continue;
+            auto first = _net._placeToPtrs[p];
+            auto last = _net._placeToPtrs[p + 1];
+            if(first == last) continue;
+            auto from = first / LANES;
+            auto to = (last + LANES - 1) / LANES;
+            for(; done < from; ++done)
+                _enabled[done] = 0;
+            for(auto b = std::max(from, done); b < to; ++b)
+            {
+                auto arcs = _blockArcs[b];
+                uint32_t valid = (1 << std::min(LANES, _net._ntransitions - b * LANES)) - 1;
+                _enabled[b] = _check(marking, &_places[arcs * LANES], &_tokens[arcs * LANES],
+                                     &_inhibitor[arcs * LANES], _blockArcs[b + 1] - arcs) & valid;
+            }
+            done = std::max(done, to);
+        }
+        for(; done < nblocks; ++done)
+            _enabled[done] = 0;
+        _suc_tcounter = 0;
+        return true;
+    }
+
+    bool VectorizedSuccessorGenerator::next(Structures::State& write)
+    {
+        uint32_t t = _suc_tcounter;
+        while(t < _net._ntransitions)
+        {
+            auto b = t / LANES;
+            uint32_t bits = _enabled[b] >> (t % LANES);
+            if(bits == 0)
+            {
+                t = (b + 1) * LANES;
+                continue;
+            }
+            while((bits & 1) == 0)
+            {
+                bits >>= 1;
+                ++t;
+            }
+            _fire(write, t);
+            _suc_tcounter = t + 1;
+            return true;
+        }
+        _suc_tcounter = std::numeric_limits<uint32_t>::max();
+        return false;
+    }
+}
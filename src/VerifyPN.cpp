@@ -67,7 +67,11 @@
 #include "PetriEngine/PQL/PQLParser.h"
 #include "PetriEngine/PQL/Contexts.h"
 #include "PetriEngine/Reachability/ReachabilitySearch.h"
+#include "PetriEngine/Reachability/ParallelReachabilitySearch.h"
+#include "PetriEngine/Reachability/ExternalBFSSearch.h"
+#include "PetriEngine/ReachabilityPortfolio.h"
 #include "PetriEngine/TAR/TARReachability.h"
+#include "PetriEngine/TAR/ContainsVisitor.h"
 #include "PetriEngine/Reducer.h"
 #include "PetriParse/QueryXMLParser.h"
 #include "PetriParse/QueryBinaryParser.h"
@@ -102,8 +106,13 @@ std::string filename = "";
 
 ReturnValue contextAnalysis(ColoredPetriNetBuilder& cpnBuilder, PetriNetBuilder& builder, const PetriNet* net, std::vector<std::shared_ptr<Condition> >& queries)
 {
-    //Context analysis
-    ColoredAnalysisContext context(builder.getPlaceNames(), builder.getTransitionNames(), net, cpnBuilder.getUnfoldedPlaceNames(), cpnBuilder.getUnfoldedTransitionNames(), cpnBuilder.isColored());
+    //Context analysis, the transitions of an unfolded net are only named if a query refers to them
+    static const std::unordered_map<std::string, uint32_t> nonames;
+    static const ColoredPetriNetBuilder::PTTransitionMap nocolorednames;
+    bool names = PetriNetBuilder::needsTransitionNames(queries);
+    ColoredAnalysisContext context(builder.getPlaceNames(), names ? builder.getTransitionNames() : nonames, net,
+                                   cpnBuilder.getUnfoldedPlaceNames(), names ? cpnBuilder.getUnfoldedTransitionNames() : nocolorednames,
+                                   cpnBuilder.isColored());
     for(auto& q : queries)
     {
         q->analyze(context);
@@ -159,6 +168,12 @@ ReturnValue parseOptions(int argc, char* argv[], options_t& options)
 				options.strategy = DFS;
 			else if(strcmp(s, "RDFS") == 0)
 				options.strategy = RDFS;
+			else if(strcmp(s, "AStar") == 0)
+				options.strategy = ASTAR;
+			else if(strcmp(s, "Beam") == 0)
+				options.strategy = BEAM;
+			else if(strcmp(s, "RestartBestFS") == 0)
+				options.strategy = RESTART;
 			else if(strcmp(s, "OverApprox") == 0)
 				options.strategy = OverApprox;
 			else{
@@ -302,6 +317,63 @@ ReturnValue parseOptions(int argc, char* argv[], options_t& options)
                 fprintf(stderr, "Argument Error: Invalid siphon-depth count \"%s\"\n", argv[i]);
                 return ErrorCode;
             }
+        } else if(strcmp(argv[i], "--bitstate") == 0) {
+            if (i == argc - 1) {
+                fprintf(stderr, "Missing number after \"%s\"\n\n", argv[i]);
+                return ErrorCode;
+            }
+            if (sscanf(argv[++i], "%u", &options.bitstate) != 1 ||
+                (options.bitstate != 0 && (options.bitstate < 10 || options.bitstate > 40))) {
+                fprintf(stderr, "Argument Error: Invalid bitstate size \"%s\", expected 0 or 10 to 40\n", argv[i]);
+                return ErrorCode;
+            }
+        } else if(strcmp(argv[i], "--simd-successors") == 0) {
+            options.vectorized_successors = true;
+        } else if(strcmp(argv[i], "--incremental-enabled") == 0) {
+            options.incremental_enabled = true;
+        } else if(strcmp(argv[i], "--beam-width") == 0) {
+            if (i == argc - 1) {
+                fprintf(stderr, "Missing number after \"%s\"\n\n", argv[i]);
+                return ErrorCode;
+            }
+            if (sscanf(argv[++i], "%zu", &options.beam_width) != 1 || options.beam_width == 0) {
+                fprintf(stderr, "Argument Error: Invalid beam width \"%s\"\n", argv[i]);
+                return ErrorCode;
+            }
+        } else if(strcmp(argv[i], "--restart-interval") == 0) {
+            if (i == argc - 1) {
+                fprintf(stderr, "Missing number after \"%s\"\n\n", argv[i]);
+                return ErrorCode;
+            }
+            if (sscanf(argv[++i], "%zu", &options.restart_interval) != 1 || options.restart_interval == 0) {
+                fprintf(stderr, "Argument Error: Invalid restart interval \"%s\"\n", argv[i]);
+                return ErrorCode;
+            }
+        } else if(strcmp(argv[i], "--external-bfs") == 0) {
+            if (i == argc - 1) {
+                fprintf(stderr, "Missing directory after \"%s\"\n\n", argv[i]);
+                return ErrorCode;
+            }
+            options.external_dir = argv[++i];
+        } else if(strcmp(argv[i], "--external-memory") == 0) {
+            if (i == argc - 1) {
+                fprintf(stderr, "Missing number after \"%s\"\n\n", argv[i]);
+                return ErrorCode;
+            }
+            if (sscanf(argv[++i], "%zu", &options.external_memory) != 1 || options.external_memory == 0) {
+                fprintf(stderr, "Argument Error: Invalid external memory size \"%s\"\n", argv[i]);
+                return ErrorCode;
+            }
+        } else if(strcmp(argv[i], "--bitstate-hashes") == 0) {
+            if (i == argc - 1) {
+                fprintf(stderr, "Missing number after \"%s\"\n\n", argv[i]);
+                return ErrorCode;
+            }
+            if (sscanf(argv[++i], "%u", &options.bitstate_hashes) != 1 ||
+                options.bitstate_hashes < 1 || options.bitstate_hashes > 16) {
+                fprintf(stderr, "Argument Error: Invalid number of bitstate hash functions \"%s\"\n", argv[i]);
+                return ErrorCode;
+            }
         }
         else if (strcmp(argv[i], "-tar") == 0)
         {
@@ -431,6 +503,26 @@ ReturnValue parseOptions(int argc, char* argv[], options_t& options)
                 }
                 i++;
             }
+        } else if (strcmp(argv[i], "--ctl-memory-limit") == 0) {
+            if (i == argc - 1) {
+                fprintf(stderr, "Missing number after \"%s\"\n\n", argv[i]);
+                return ErrorCode;
+            }
+            if (sscanf(argv[++i], "%zu", &options.ctl_memory_limit) != 1) {
+                fprintf(stderr, "Argument Error: Invalid CTL memory limit \"%s\"\n", argv[i]);
+                return ErrorCode;
+            }
+            // given in MB, kept in bytes so it can be split between threads
+            options.ctl_memory_limit *= 1024 * 1024;
+        } else if (strcmp(argv[i], "--ctl-dfs-ratio") == 0) {
+            if (i == argc - 1) {
+                fprintf(stderr, "Missing number after \"%s\"\n\n", argv[i]);
+                return ErrorCode;
+            }
+            if (sscanf(argv[++i], "%u", &options.ctl_dfs_ratio) != 1 || options.ctl_dfs_ratio > 100) {
+                fprintf(stderr, "Argument Error: Invalid DFS ratio \"%s\"\n", argv[i]);
+                return ErrorCode;
+            }
         } else if (strcmp(argv[i], "-ltl") == 0) {
             options.logic = TemporalLogic::LTL;
             if (argc > i + 1) {
@@ -497,6 +589,8 @@ ReturnValue parseOptions(int argc, char* argv[], options_t& options)
             options.gamemode = true;
         } else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--cpn-overapproximation") == 0) {
             options.cpnOverApprox = true;
+        } else if (strcmp(argv[i], "--colored-search") == 0) {
+            options.colored_search = true;
         } else if (strcmp(argv[i], "--disable-cfp") == 0) {
             options.computeCFP = false;
         } else if (strcmp(argv[i], "--disable-partitioning") == 0) {
@@ -518,6 +612,11 @@ ReturnValue parseOptions(int argc, char* argv[], options_t& options)
                     "                                       - BFS          Breadth first search\n"
                     "                                       - DFS          Depth first search (CTL default)\n"
                     "                                       - RDFS         Random depth first search\n"
+                    "                                       - AStar        Heuristic search ordered by depth + distance\n"
+                    "                                       - Beam         Heuristic search keeping only the best states\n"
+                    "                                                      (see --beam-width), possibly incomplete\n"
+                    "                                       - RestartBestFS Heuristic search restarting from a random state\n"
+                    "                                                      (see --restart-interval)\n"
                     "                                       - OverApprox   Linear Over Approx\n"
                     "  --seed-offset <number>               Extra noise to add to the seed of the random number generation\n"
                     "  -e, --state-space-exploration        State-space exploration only (query-file is irrelevant)\n"
@@ -554,14 +653,34 @@ ReturnValue parseOptions(int argc, char* argv[], options_t& options)
                     "                                       - fire-count     Prioritises transitions that were fired less often.\n"
                     "  -a, --siphon-trap <timeout>          Siphon-Trap analysis timeout in seconds (default 0)\n"
                     "      --siphon-depth <place count>     Search depth of siphon (default 0, which counts all places)\n"
+                    "  --bitstate <bits>                    Store visited states in a bitstate table of 2^<bits> bits (10-40)\n"
+                    "                                       instead of exactly. Uses far less memory, but the search is\n"
+                    "                                       possibly incomplete; used by reachability and LTL (tarjan) without traces\n"
+                    "  --bitstate-hashes <number>           Number of hash functions of the bitstate table (default 3)\n"
+                    "  --simd-successors                    Check enabledness of blocks of transitions using SIMD instructions\n"
+                    "                                       (AVX2 or SSE4.1 if available), for reachability without stubborn reduction\n"
+                    "  --beam-width <number>                Number of states kept by the Beam search strategy (default 10000)\n"
+                    "  --restart-interval <number>          States expanded between the restarts of RestartBestFS (default 1000)\n"
+                    "  --incremental-enabled                Update the enabled transitions of a state from those of the previously\n"
+                    "                                       expanded state, for reachability (works best with DFS)\n"
+                    "  --external-bfs <directory>           Breadth first search storing the state space in sorted files in <directory>,\n"
+                    "                                       for reachability without traces\n"
+                    "  --external-memory <MB>               Memory used for successors before they are written to disk (default 1024)\n"
                     "  -n, --no-statistics                  Do not display any statistics (default is to display it)\n"
                     "  -h, --help                           Display this help message\n"
                     "  -v, --version                        Display version information\n"
                     "  -ctl <type>                          Verify CTL properties\n"
                     "                                       - local     Liu and Smolka's on-the-fly algorithm\n"
                     "                                       - czero     local with certain zero extension (default)\n"
+                    "  --ctl-memory-limit <MB>              Reclaim decided configurations of the CTL dependency graph\n"
+                    "                                       whenever it exceeds the limit (default 0, no limit)\n"
+                    "  --ctl-dfs-ratio <0-100>              Percentage of the edges the CTL engine takes depth-first when\n"
+                    "                                       searching with BestFS, the rest by distance (default 0)\n"
                     "  -ltl [<type>]                        Verify LTL properties (default tarjan). If omitted the queries are assumed to be CTL.\n"
                     "                                       - ndfs      Nested depth first search algorithm\n"
+#ifdef VERIFYPN_MC_Simplification
+                    "                                                   multi-core (CNDFS) with -z and no trace\n"
+#endif
                     "                                       - tarjan    On-the-fly Tarjan's algorithm\n"
                     "                                       - none      Run preprocessing steps only.\n"
                     "  -noweak                              Disable optimizations for weak Büchi automata when doing \n"
@@ -569,12 +688,20 @@ ReturnValue parseOptions(int argc, char* argv[], options_t& options)
                     "  -noreach                             Force use of CTL/LTL engine, even when queries are reachability.\n"
                     "                                       Not recommended since the reachability engine is faster.\n"
                     "  -c, --cpn-overapproximation          Over approximate query on Colored Petri Nets (CPN only)\n"
+                    "  --colored-search                     Search the state space of the colored net without unfolding it,\n"
+                    "                                       for reachability queries without fireability and deadlock (CPN only)\n"
                     "  --disable-cfp                        Disable the computation of possible colors in the Petri Net (CPN only)\n"
                     "  --disable-partitioning               Disable the partitioning of colors in the Petri Net (CPN only)\n"
                     "  --disable-symmetry-vars              Disable search for symmetric variables (CPN only)\n"
                     //"  -g                                 Enable game mode (CTL Only)" // Feature not yet implemented
 #ifdef VERIFYPN_MC_Simplification
-                    "  -z <number of cores>                 Number of cores to use (currently only query simplification)\n"
+                    "  -z <number of cores>                 Number of cores to use for unfolding, query simplification and verification.\n"
+                    "                                       Note: with more than one core and no search strategy (-s), reachability\n"
+                    "                                       queries are verified by a portfolio of engines run in parallel instead of\n"
+                    "                                       the default search. Otherwise the state space is searched with several\n"
+                    "                                       threads, except with the A*, beam and restart strategies.\n"
+                    "                                       Independent CTL and LTL queries are verified in parallel, and a single LTL\n"
+                    "                                       query is searched with several threads when using -ltl ndfs.\n"
 #endif
                     "  -tar                                 Enables Trace Abstraction Refinement for reachability properties\n"
                     "  --max-intervals <interval count>     The max amount of intervals kept when computing the color fixpoint\n"
@@ -669,6 +796,21 @@ ReturnValue parseOptions(int argc, char* argv[], options_t& options)
 //        outputtrace = false;
     }
 
+    if (options.colored_search) {
+        // the colored net is searched as it is, so it is neither reduced nor analysed for unfolding
+        options.enablereduction = 0;
+        options.stubbornreduction = false;
+        options.siphontrapTimeout = 0;
+        options.tar = false;
+        options.computeCFP = false;
+        options.computePartition = false;
+        options.symmetricVariables = false;
+        if (options.trace != TraceLevel::None) {
+            fprintf(stderr, "Argument Error: Traces are not supported by --colored-search\n");
+            return ErrorCode;
+        }
+    }
+
 
     //----------------------- Validate Arguments -----------------------//
 
@@ -1003,10 +1145,15 @@ void writeQueries(const std::vector<std::shared_ptr<Condition>>& queries, std::v
 }
 
 void writeCompactQueries(const std::vector<std::shared_ptr<Condition>>& queries, std::vector<std::string>& querynames, std::vector<uint32_t>& order,
-    std::string& filename, const ColoredPetriNetBuilder& cpnBuilder, const PetriNetBuilder& builder, const PetriNet* net)
+    std::string& filename, ColoredPetriNetBuilder& cpnBuilder, PetriNetBuilder& builder, const PetriNet* net)
 {
     std::fstream out;
-    ColoredAnalysisContext context(builder.getPlaceNames(), builder.getTransitionNames(), net, cpnBuilder.getUnfoldedPlaceNames(), cpnBuilder.getUnfoldedTransitionNames(), cpnBuilder.isColored());
+    static const std::unordered_map<std::string, uint32_t> nonames;
+    static const ColoredPetriNetBuilder::PTTransitionMap nocolorednames;
+    bool names = PetriNetBuilder::needsTransitionNames(queries);
+    ColoredAnalysisContext context(builder.getPlaceNames(), names ? builder.getTransitionNames() : nonames, net,
+                                   cpnBuilder.getUnfoldedPlaceNames(), names ? cpnBuilder.getUnfoldedTransitionNames() : nocolorednames,
+                                   cpnBuilder.isColored());
 
     out.open(filename, std::ios::out);
     out << "<?xml version=\"1.0\"?>\n<property-set xmlns=\"http://mcc.lip6.fr/\">\n";
@@ -1156,8 +1303,8 @@ void outputQueries(const PetriNetBuilder &builder, const std::vector<PetriEngine
     writeQueries(queries, querynames, reorder, filename, binary_query_io & 2, builder.getPlaceNames());
 }
 
-void outputCompactQueries(const PetriNetBuilder &builder, const PetriNetBuilder &b2, const PetriNet *net,
-        const PetriEngine::ColoredPetriNetBuilder& cpnBuilder, const std::vector<PetriEngine::PQL::Condition_ptr> &queries,
+void outputCompactQueries(const PetriNetBuilder &builder, PetriNetBuilder &b2, const PetriNet *net,
+        PetriEngine::ColoredPetriNetBuilder& cpnBuilder, const std::vector<PetriEngine::PQL::Condition_ptr> &queries,
         std::vector<std::string> &querynames, std::string filename){
     //Don't know if this is needed
     std::vector<uint32_t> reorder(queries.size());
@@ -1186,6 +1333,11 @@ int main(int argc, char* argv[]) {
         std::cerr << "CPN OverApproximation is only usable on colored models" << std::endl;
         return UnknownCode;
     }
+    if(options.colored_search && !cpnBuilder.isColored())
+    {
+        std::cerr << "Colored search is only usable on colored models" << std::endl;
+        return UnknownCode;
+    }
     if (options.printstatistics) {
         std::cout << "Finished parsing model" << std::endl;
     }
@@ -1236,6 +1388,23 @@ int main(int argc, char* argv[]) {
             }
         }
     }
+    else if (options.colored_search) {
+        // the search evaluates the queries on the number of tokens of the colored places,
+        // which the net without colors has, but it does not tell which colored transitions are enabled
+        for (ssize_t qid = queries.size() - 1; qid >= 0; --qid) {
+            bool supported = queries[qid]->isReachability() && !queries[qid]->isLoopSensitive();
+            if (supported) {
+                ContainsVisitor<FireableCondition> fireability;
+                queries[qid]->visit(fireability);
+                supported = !fireability.does_contain();
+            }
+            if (!supported) {
+                std::cerr << "Warning: Colored search is only available for Reachability queries without deadlock, fireability and UpperBounds, skipping " << querynames[qid] << std::endl;
+                queries.erase(queries.begin() + qid);
+                querynames.erase(querynames.begin() + qid);
+            }
+        }
+    }
 
 
     if(options.computePartition){
@@ -1250,7 +1419,8 @@ int main(int argc, char* argv[]) {
     }
 
 
-    auto builder = options.cpnOverApprox ? cpnBuilder.stripColors() : cpnBuilder.unfold();
+    // the net without colors over-approximates the colored net, so the query simplification stays sound for the colored search
+    auto builder = options.cpnOverApprox || options.colored_search ? cpnBuilder.stripColors() : cpnBuilder.unfold(options.cores);
     printUnfoldingStats(cpnBuilder, options);
     builder.sort();
     std::vector<ResultPrinter::Result> results(queries.size(), ResultPrinter::Result::Unknown);
@@ -1586,27 +1756,33 @@ int main(int argc, char* argv[]) {
                 return v;
             }
 
-            for (auto qid : ltl_ids) {
-                auto res = LTL::LTLMain(net.get(), queries[qid], querynames[qid], options, builder.getReducer());
-                std::cout << "\nQuery index " << qid << " was solved\n";
-                std::cout << "Query is " << (res ? "" : "NOT ") << "satisfied." << std::endl;
-
-            }
+            LTL::LTLMain(net.get(), queries, querynames, ltl_ids, options, builder.getReducer());
             if (std::find(results.begin(), results.end(), ResultPrinter::Unknown) == results.end()) {
                 return SuccessCode;
             }
         }
 
+#ifdef VERIFYPN_MC_Simplification
+        // with several cores and no explicit choice of engine, race the engines against each other
+        bool portfolio = options.cores > 1 && options.strategy == DEFAULT && !options.tar &&
+                         options.trace == TraceLevel::None && !options.statespaceexploration &&
+                         options.bitstate == 0 && options.external_dir.empty() && !options.colored_search &&
+                         ReachabilityPortfolio::supports(queries);
+#else
+        bool portfolio = false;
+#endif
+
         //----------------------- Siphon Trap ------------------------//
 
-        if(options.siphontrapTimeout > 0){
+        // the portfolio runs the siphon-trap analysis alongside the other engines
+        if(options.siphontrapTimeout > 0 && !portfolio){
             for (uint32_t i = 0; i < results.size(); i ++) {
                 bool isDeadlockQuery = std::dynamic_pointer_cast<DeadlockCondition>(queries[i]) != nullptr;
 
                 if (results[i] == ResultPrinter::Unknown && isDeadlockQuery) {
                     STSolver stSolver(printer, *net, queries[i].get(), options.siphonDepth);
                     stSolver.solve(options.siphontrapTimeout);
-                    results[i] = stSolver.printResult();
+                    results[i] = stSolver.printResult(i);
                     if (results[i] == Reachability::ResultPrinter::NotSatisfied && options.printstatistics) {
                         std::cout << "Query solved by Siphon-Trap Analysis." << std::endl << std::endl;
                     }
@@ -1617,7 +1793,7 @@ int main(int argc, char* argv[]) {
                 return SuccessCode;
             }
         }
-        options.siphontrapTimeout = 0;
+        if(!portfolio) options.siphontrapTimeout = 0;
 
         //----------------------- Reachability -----------------------//
 
@@ -1627,7 +1803,28 @@ int main(int argc, char* argv[]) {
         // Change default place-holder to default strategy
         if(options.strategy == DEFAULT) options.strategy = PetriEngine::Reachability::HEUR;
 
-        if(options.tar && net->numberOfPlaces() > 0)
+        if(portfolio)
+        {
+            ReachabilityPortfolio strategy(printer, *net, builder.getReducer(), options);
+            strategy.reachable(queries, results);
+        }
+        else if(options.colored_search)
+        {
+            ReachabilitySearch strategy(*net, printer, options.kbound);
+            strategy.setColoredNet(&cpnBuilder);
+            strategy.setBeamWidth(options.beam_width);
+            strategy.setRestartInterval(options.restart_interval);
+
+            //Reachability search
+            strategy.reachable(queries, results,
+                            options.strategy,
+                            false,
+                            options.statespaceexploration,
+                            options.printstatistics,
+                            false,
+                            options.seed());
+        }
+        else if(options.tar && net->numberOfPlaces() > 0)
         {
             //Create reachability search strategy
             TARReachabilitySearch strategy(printer, *net, builder.getReducer(), options.kbound);
@@ -1641,9 +1838,46 @@ int main(int argc, char* argv[]) {
                     options.printstatistics,
                     options.trace != TraceLevel::None);
         }
+        else if(!options.external_dir.empty() && options.trace == TraceLevel::None)
+        {
+            ExternalBFSSearch strategy(*net, printer, options.external_dir,
+                                       options.external_memory * 1024 * 1024, options.kbound);
+
+            if(options.strategy != PetriEngine::Reachability::BFS && options.strategy != PetriEngine::Reachability::HEUR)
+                fprintf(stdout, "Search strategy option was ignored as the external BFS is used.\n");
+            options.strategy = PetriEngine::Reachability::BFS;
+
+            //Reachability search
+            strategy.reachable(queries, results,
+                            options.stubbornreduction,
+                            options.statespaceexploration,
+                            options.printstatistics);
+        }
+#ifdef VERIFYPN_MC_Simplification
+        else if(options.cores > 1 && options.trace == TraceLevel::None && options.bitstate == 0 &&
+                options.strategy != ASTAR && options.strategy != BEAM && options.strategy != RESTART)
+        {
+            ParallelReachabilitySearch strategy(*net, printer, options.cores, options.kbound);
+            strategy.setVectorized(options.vectorized_successors);
+            strategy.setIncremental(options.incremental_enabled);
+
+            //Reachability search
+            strategy.reachable(queries, results,
+                            options.strategy,
+                            options.stubbornreduction,
+                            options.statespaceexploration,
+                            options.printstatistics,
+                            options.seed());
+        }
+#endif
         else
         {
             ReachabilitySearch strategy(*net, printer, options.kbound);
+            strategy.setBitstate(options.bitstate, options.bitstate_hashes);
+            strategy.setVectorized(options.vectorized_successors);
+            strategy.setIncremental(options.incremental_enabled);
+            strategy.setBeamWidth(options.beam_width);
+            strategy.setRestartInterval(options.restart_interval);
 
             // Change default place-holder to default strategy
             if(options.strategy == DEFAULT) options.strategy = PetriEngine::Reachability::HEUR;